@@ -0,0 +1,180 @@
+(*
+ *  comments.cl
+ *
+ *  A benchmark input for the scanner that is mostly comments and white
+ *  space, as COOL programs written for a course tend to be: a block
+ *  comment before every class and method, -- comments at the ends of
+ *  lines, nested (* *) comments around code that has been taken out,
+ *  and indentation with both blanks and tabs.
+ *
+ *  The program itself is a small stack of integers with a driver that
+ *  pushes, pops and prints; it lexes, parses and runs.
+ *)
+
+(*
+ *  Class Stack
+ *
+ *  An empty stack.  Every operation of a non-empty stack is also an
+ *  operation here, so that the driver can use one type for both; the
+ *  operations that need an element (top, pop) are errors on the empty
+ *  stack and abort.
+ *
+ *  (* The first version kept a count of the elements in an attribute,
+ *     but nothing used it:
+ *
+ *         size : Int <- 0;
+ *
+ *     (* and it had to be kept up to date by push and pop, *) so it
+ *     went. *)
+ *)
+class Stack inherits IO {
+
+   -- isEmpty: true for the empty stack and only for it
+   isEmpty() : Bool { true };
+
+   -- top: the element pushed last; there is none
+   top() : Int {
+      {
+         abort();       -- no element to return
+         0;             -- never reached, but the body must be an Int
+      }
+   };
+
+   -- pop: the stack without its top element; there is none
+   pop() : Stack {
+      {
+         abort();       -- nothing to take off
+         self;          -- never reached
+      }
+   };
+
+   (*
+    *  push: a new stack with "i" on top of this one.  The new stack
+    *  is a Cons whose rest is self, so pushing never copies.
+    *)
+   push(i : Int) : Stack {
+      (new Cons).init(i, self)
+   };
+
+   (*
+    *  print: write the elements from the top down, one per line.
+    *  The empty stack writes nothing.
+    *)
+   print() : Object { self };
+
+};
+
+(*
+ *  Class Cons
+ *
+ *  A stack with at least one element: "car" is its top and "cdr" the
+ *  stack under it.  init must be called before anything else; push does
+ *  that.
+ *)
+class Cons inherits Stack {
+
+	car : Int;		-- the top element
+	cdr : Stack;		-- the rest of the stack
+
+	-- isEmpty: a Cons is never empty
+	isEmpty() : Bool { false };
+
+	-- top: the first element
+	top() : Int { car };
+
+	-- pop: everything under the first element
+	pop() : Stack { cdr };
+
+	(*
+	 *  init: set the top and the rest, and return self so that
+	 *  the call can be the value of push.
+	 *
+	 *  (* An earlier init checked that "rest" was not void:
+	 *
+	 *	if isvoid rest then abort() else self fi
+	 *
+	 *     but push is the only caller and never passes void. *)
+	 *)
+	init(i : Int, rest : Stack) : Stack {
+	   {
+	      car <- i;		-- the new top
+	      cdr <- rest;	-- the old stack
+	      self;
+	   }
+	};
+
+	(*
+	 *  print: the top, then the rest.  Recursion is fine here;
+	 *  the stacks the driver builds are short.
+	 *)
+	print() : Object {
+	   {
+	      out_int(car);	-- the element
+	      out_string("\n");	-- one per line
+	      cdr.print();	-- and the rest below it
+	   }
+	};
+
+};
+
+(*
+ *  Class Main
+ *
+ *  Pushes the numbers 1 to 10, prints the stack, pops three and
+ *  prints it again.
+ *
+ *  (* (* (* Three levels of comment, to be sure that nesting is
+ *           counted and not just matched. *) *) *)
+ *)
+class Main inherits IO {
+
+   stack : Stack <- new Stack;     -- starts empty
+
+   -- fill: push the numbers from 1 to n
+   fill(n : Int) : Stack {
+      let i : Int <- 1 in           -- the next number to push
+         {
+            while i <= n loop       -- up to and including n
+               {
+                  stack <- stack.push(i);
+                  i <- i + 1;       -- next
+               }
+            pool;
+            stack;                  -- the value of fill
+         }
+   };
+
+   -- drop: pop k elements, or as many as there are
+   drop(k : Int) : Stack {
+      {
+         while 0 < k loop
+            if stack.isEmpty() then
+               k <- 0               -- nothing left to pop
+            else
+               {
+                  stack <- stack.pop();
+                  k <- k - 1;
+               }
+            fi
+         pool;
+         stack;
+      }
+   };
+
+   (*
+    *  main: the driver.  The lines between the prints were once
+    *
+    *     (* out_string("after fill\n"); *)
+    *     (* out_string("after drop\n"); *)
+    *
+    *  and are kept here as comments because they are comments.
+    *)
+   main() : Object {
+      {
+         fill(10).print();          -- 10 down to 1
+         out_string("--\n");        -- not a comment: inside a string
+         drop(3).print();           -- 7 down to 1
+      }
+   };
+
+};
@@ -0,0 +1,3 @@
+class Main {};
+(* open (* nested *)
+  still open
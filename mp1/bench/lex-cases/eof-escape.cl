@@ -0,0 +1,2 @@
+class Main {};
+"ends in a backslash \
\ No newline at end of file
@@ -0,0 +1,2 @@
+class Main {};
+"runs to the end
\ No newline at end of file
@@ -0,0 +1,4 @@
+CLASS Class cLaSs iF THEN eLsE fI wHiLe LOOP pOoL LeT iN CaSe EsAc Of NeW iSvOiD NoT iNhErItS
+true tRUE True false fALSE False self SELF_TYPE Self_Type
+x1_Y2 Z9_ 0123 9876543210 <- <= < => = -- line comment
++ - * / ~ . , ; : ( ) @ { } -->
@@ -0,0 +1,98 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _AST_BINARY_H_
+#define _AST_BINARY_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  ast-binary.h
+//
+//  A compact binary form of the typed AST, for handing the tree from
+//  the parser to semant and cgen without printing it with
+//  dump_with_types and re-lexing and re-parsing it with ast-lex and
+//  ast-parse.  All numbers are unsigned LEB128 varints.
+//
+//     header   0x7f 'C' 'A' 'S' 'T' version
+//     strings  three sections, for idtable, inttable and stringtable,
+//              each a count followed by (length, bytes) per entry
+//     program  the line number of the program node, the number of
+//              classes, and for each class the offset of its subtree
+//              from the start of the tree section
+//     tree     the classes, each in preorder; each node is a tag and its
+//              line number followed by its fields in constructor order.
+//              Symbols are 1-based indices into the section of the
+//              table they belong to (0 for NULL), lists are a length
+//              followed by the elements, and every Expression ends with
+//              its type.
+//
+//  Each distinct string is interned once when the tree is read, instead
+//  of once per occurrence.  The text format stays available for
+//  debugging; readers tell the two apart by the first byte.
+//
+//  The class index lets a reader decode classes on demand.  The Program
+//  returned by read_binary_ast holds a list of classes that decodes the
+//  nth class the first time it is asked for and keeps it; everything
+//  else is ordinary cool-tree.h nodes.  When the input is a regular
+//  file it is mapped with mmap rather than read, so classes that are
+//  never touched are never paged in.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include "cool-tree.h"
+
+#define AST_BINARY_VERSION 2
+
+class AstWriter {
+private:
+  enum { ID_TABLE, INT_TABLE, STR_TABLE, NTABLES };
+
+  std::string tree;                        // encoded nodes
+  std::map<Symbol, int> index[NTABLES];    // symbol -> 1-based position
+  std::vector<Symbol> symbols[NTABLES];    // symbols in order of position
+  int program_line;
+  std::vector<size_t> class_offsets;       // where each class starts in tree
+
+  void symbol(int table, Symbol s);
+  void string(std::string& out, const char *s, int len);
+  void number(std::string& out, unsigned long n);
+
+public:
+  AstWriter() : program_line(0) { }
+  void program(tree_node *t, Classes classes);
+  void node(int tag, tree_node *t);
+  void number(unsigned long n)           { number(tree, n); }
+  void boolean(Boolean b)                { number(tree, b ? 1 : 0); }
+  void id_symbol(Symbol s)               { symbol(ID_TABLE, s); }
+  void int_symbol(Symbol s)              { symbol(INT_TABLE, s); }
+  void string_symbol(Symbol s)           { symbol(STR_TABLE, s); }
+
+  template <class Elem> void list(list_node<Elem> *l)
+  {
+    number(l->len());
+    for(int i = l->first(); l->more(i); i = l->next(i))
+      l->nth(i)->dump_binary(*this);
+  }
+
+  // write the header, the string sections, the class index and the tree
+  void finish(ostream& stream);
+};
+
+// write the tree under "p" in the binary format
+void dump_binary_ast(ostream& stream, Program p);
+
+// does "f" start with a binary AST?  Nothing is consumed.
+bool is_binary_ast(FILE *f);
+
+// read a binary AST from "f"; classes are decoded when first used.
+// Malformed input is a fatal error.
+Program read_binary_ast(FILE *f);
+
+#endif
@@ -0,0 +1,79 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _AST_CENSUS_H_
+#define _AST_CENSUS_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  ast-census.h
+//
+//  An AstCensus is filled in by the census() method of every AST node
+//  (see ast-census.cc) and records:
+//
+//     node counts and bytes per constructor class (dispatch_class, ...)
+//     a histogram of node depth
+//     for each list phylum, the height of the tree of append_node cells
+//     against the length of the list
+//
+//  The last one is there to catch the left-deep lists that a grammar
+//  appending one element at a time produces; every nth() on such a list
+//  walks the whole spine.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <vector>
+#include "cool-tree.h"
+
+class AstCensus {
+private:
+  struct kind_count {
+    long nodes;
+    long bytes;
+  };
+  struct length_count {          // lists whose length is in [2^k, 2^(k+1))
+    long lists;
+    long height_sum;
+    int max_height;
+  };
+  struct list_count {
+    long lists;
+    long elems;
+    long cells;
+    long bytes;
+    long left_deep;              // lists of 3 or more with height len-1
+    int max_len;
+    int max_height;
+    std::map<int, length_count> by_length;
+  };
+
+  std::map<std::string, kind_count> kinds;
+  std::map<std::string, list_count> lists;
+  std::vector<long> depths;
+
+  void add_list(const char *phylum, int len, int height, list_shape &s);
+
+public:
+  // record one AST node of constructor class "kind" at depth "depth"
+  void node(const char *kind, int bytes, int depth);
+
+  // record the shape of list "l"; its elements are visited separately
+  template <class Elem> void list(const char *phylum, list_node<Elem> *l)
+  {
+    list_shape s = { 0, 0, 0, 0 };
+    int height = l->shape(s);
+    add_list(phylum, l->len(), height, s);
+  }
+
+  void report(ostream& stream);
+};
+
+// walk the tree under "p" and print its census on "stream"
+void ast_census(Program p, ostream& stream);
+
+#endif
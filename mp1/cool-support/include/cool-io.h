@@ -47,5 +47,30 @@ using std::setfill;
 
 #endif // COOL_USE_OLD_HEADERS
 
+#include <stdio.h>
+
+//
+// Output layer shared by the dumpers (see utilities.cc).
+//
+// buffer_cout puts a large buffer under cout that goes to stdout only
+// when it fills or when cout is flushed, and flushes it at exit.  The
+// phases call it first thing in main, and the dumpers end lines with
+// '\n' rather than endl, so an AST or token stream goes down the pipe
+// in 64K writes instead of one write per line.
+//
+extern void buffer_cout();
+
+//
+// pad(n) is n blanks of indentation, or none at all in a compact dump
+// (-k).  Streaming it writes spans of a static row of blanks, so deep
+// trees keep their full indentation.
+//
+struct pad {
+  int n;
+  pad(int n);
+};
+
+extern ostream& operator<<(ostream& stream, const pad& p);
+
 
 #endif //COOL_IO_H
@@ -0,0 +1,39 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _COOL_KEYWORDS_H_
+#define _COOL_KEYWORDS_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  cool-keywords.h
+//
+//  The keywords of COOL, recognised in an identifier after the scanner
+//  has matched it.  Keywords are case-insensitive except that true and
+//  false must begin with a lower-case letter, so written as flex
+//  patterns each needs a class per letter, [cC][lL][aA][sS][sS], and
+//  every one of them adds states to the DFA that every identifier is
+//  run through.  With cool_keyword the scanner needs one rule for
+//  identifiers:
+//
+//      [a-zA-Z][a-zA-Z0-9_]*   {
+//          int token = cool_keyword(yytext, yyleng);
+//          if (token == BOOL_CONST)
+//              cool_yylval.boolean = (yytext[0] == 't');
+//          else if (token == 0) ...    an OBJECTID or TYPEID
+//          ...
+//      }
+//
+//  The lookup is a perfect hash of the case-folded text, so it costs a
+//  few arithmetic operations and one comparison with a single keyword.
+//
+//////////////////////////////////////////////////////////////////////
+
+// the token of the identifier text[0..len-1] if it is a keyword, with
+// BOOL_CONST for true and false; 0 if it is not a keyword
+int cool_keyword(const char *text, int len);
+
+#endif
@@ -93,7 +93,7 @@ typedef union {
 # define	ERROR	283
 
 
-extern YYSTYPE cool_yylval;
+extern parser_local YYSTYPE cool_yylval;
 
 #endif /* not BISON_COOL_TAB_H */
 #endif
@@ -0,0 +1,122 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _COOL_SCANNER_H_
+#define _COOL_SCANNER_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  cool-scanner.h
+//
+//  Scanner instances, so that several files can be scanned at once on
+//  different threads of one process.
+//
+//  The flex scanner of cool-lex.cc keeps its state in globals: fin,
+//  string_buf, string_buf_ptr, curr_lineno and cool_yylval of cool.flex,
+//  and flex's own buffer stack, start state and yytext.  A cool_scanner
+//  is backed by a scanner_engine, a copy of cool-lex.cc compiled on its
+//  own (scanner-engine.cc) with all of those wrapped in a namespace of
+//  its own, so each engine is a separate scanner.  The Makefile builds
+//  SCANNER_ENGINES of them; a cool_scanner takes a free one for its
+//  lifetime and, when every engine is taken, waits for one to be given
+//  back.
+//
+//  cool.flex itself is unchanged and need not know about any of this.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "cool-parse.h"
+#include "line-index.h"
+
+//
+// A token with everything the parser needs to know about it.  The
+// scanners hand tokens over token_batch at a time, so that the parser
+// reads its tokens from an array instead of calling the scanner for
+// each one.
+//
+struct scanned_token {
+  int token;
+  int lineno;
+  const char *filename;
+  YYSTYPE value;
+};
+
+const int token_batch = 256;
+
+//
+// One copy of the flex scanner: its globals and its entry points.
+//
+struct scanner_engine {
+  int *curr_lineno;
+  YYSTYPE *cool_yylval;
+  int *flex_debug;                // yy_flex_debug of this copy
+  char **yytext;                  // the text of the last token
+  int *yyleng;
+
+  int (*lex)();                   // cool_yylex
+  void (*start)(FILE *f, char *text, size_t size);
+  void (*finish)();               // frees flex's buffer for the file
+
+  scanner_engine *next;           // all the engines of the program
+  bool busy;                      // taken by a cool_scanner
+
+  scanner_engine(int *lineno, YYSTYPE *yylval, int *debug, char **text,
+		 int *leng, int (*l)(), void (*s)(FILE *, char *, size_t),
+		 void (*f)());
+};
+
+class cool_scanner {
+private:
+  scanner_engine *engine;
+  char *text;                     // the whole file
+  char *owned;                    // text, if this scanner read it
+  line_index lines;               // of text, if it is a file
+  bool indexed;
+  int line;                       // of the last token, from lines
+
+  int text_line();
+
+public:
+  const char *filename;
+
+  cool_scanner();                 // waits for a free engine
+  ~cool_scanner();                // gives it back
+
+  // scan "f" from its start; "name" is the file name of its tokens.
+  // All of it is read first, even from a pipe.
+  void open(FILE *f, const char *name);
+
+  // scan "size" bytes of "text" in place; text[size] and text[size + 1]
+  // must be NUL.  The text is left as it was once the scanner is closed
+  // or opened again.  Tokens have no line numbers (lineno() is that of
+  // the scanner), but token_start() and token_end() give where they are.
+  void open(char *text, size_t size, const char *name);
+
+  // the next token of the file, or 0 at its end; its line number and
+  // value are those of lineno() and value() until the next call.  The
+  // line number comes from where the token ends in the text (see
+  // line-index.h).  The engine's curr_lineno, which cool.flex may
+  // count, is not used; the hand-written engine does not keep it.
+  int next()                 { return engine->lex(); }
+  int lineno()
+    { return indexed ? text_line() : *engine->curr_lineno; }
+  const YYSTYPE& value() const { return *engine->cool_yylval; }
+
+  // the column the token starts at, or 0 for text scanned in place
+  int column() const;
+
+  // the offsets in the text of the token and of the byte after it, for
+  // a file read whole or text scanned in place
+  size_t token_start() const { return *engine->yytext - text; }
+  size_t token_end() const   { return token_start() + *engine->yyleng; }
+
+  // scan up to "max" tokens of the file into "tokens"; returns how many,
+  // fewer than "max" only at the end of the file.  There is no token 0.
+  int scan(scanned_token *tokens, int max);
+};
+
+#endif
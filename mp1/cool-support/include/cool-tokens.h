@@ -0,0 +1,97 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef COOL_TOKENS_H
+#define COOL_TOKENS_H
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  cool-tokens.h
+//
+//  One table of the COOL tokens, for everything that prints or reads
+//  token streams (utilities.cc, the lexer driver, the token readers).
+//  For each token code it gives the name the token is printed under and
+//  the semantic value it carries in cool_yylval.
+//
+//  COOL_TOKENS lists the %token declarations of cool.y with their
+//  numbers.  utilities.cc checks every number against cool-parse.h at
+//  compile time, so the list cannot drift from the grammar.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+enum cool_token_value {
+  TOKVAL_NONE,          // no value
+  TOKVAL_ID,            // cool_yylval.symbol, in idtable
+  TOKVAL_INT,           // cool_yylval.symbol, in inttable
+  TOKVAL_STR,           // cool_yylval.symbol, in stringtable
+  TOKVAL_BOOL,          // cool_yylval.boolean
+  TOKVAL_ERROR          // cool_yylval.error_msg
+};
+
+#define COOL_TOKENS(X) \
+  X(CLASS,      258, NONE)  \
+  X(ELSE,       259, NONE)  \
+  X(FI,         260, NONE)  \
+  X(IF,         261, NONE)  \
+  X(IN,         262, NONE)  \
+  X(INHERITS,   263, NONE)  \
+  X(LET,        264, NONE)  \
+  X(LOOP,       265, NONE)  \
+  X(POOL,       266, NONE)  \
+  X(THEN,       267, NONE)  \
+  X(WHILE,      268, NONE)  \
+  X(CASE,       269, NONE)  \
+  X(ESAC,       270, NONE)  \
+  X(OF,         271, NONE)  \
+  X(DARROW,     272, NONE)  \
+  X(NEW,        273, NONE)  \
+  X(ISVOID,     274, NONE)  \
+  X(STR_CONST,  275, STR)   \
+  X(INT_CONST,  276, INT)   \
+  X(BOOL_CONST, 277, BOOL)  \
+  X(TYPEID,     278, ID)    \
+  X(OBJECTID,   279, ID)    \
+  X(ASSIGN,     280, NONE)  \
+  X(NOT,        281, NONE)  \
+  X(LE,         282, NONE)  \
+  X(ERROR,      283, ERROR)
+
+// the single character tokens, which are their own codes and are
+// printed quoted, e.g. '+'
+#define COOL_CHAR_TOKENS(X) \
+  X('+') X('/') X('-') X('*') X('=') X('<') X('.') X('~') \
+  X(',') X(';') X(':') X('(') X(')') X('@') X('{') X('}')
+
+#define COOL_TOKEN_LIMIT 284    // one more than the largest token code
+
+struct cool_token_info {
+  const char *name;             // NULL if the code is not a token
+  cool_token_value value;
+};
+
+struct cool_token_table {
+  cool_token_info info[COOL_TOKEN_LIMIT];
+
+  constexpr cool_token_table() : info{} {
+    info[0] = { "EOF", TOKVAL_NONE };         // what yylex returns at the end
+#define COOL_TOKEN_ENTRY(tok, num, val) info[num] = { #tok, TOKVAL_##val };
+#define COOL_CHAR_ENTRY(c)              info[c] = { #c, TOKVAL_NONE };
+    COOL_TOKENS(COOL_TOKEN_ENTRY)
+    COOL_CHAR_TOKENS(COOL_CHAR_ENTRY)
+#undef COOL_TOKEN_ENTRY
+#undef COOL_CHAR_ENTRY
+  }
+
+  // the entry for a token code, or NULL
+  constexpr const cool_token_info *lookup(int tok) const {
+    return (tok >= 0 && tok < COOL_TOKEN_LIMIT && info[tok].name)
+      ? &info[tok] : (const cool_token_info *) 0;
+  }
+};
+
+inline constexpr cool_token_table cool_tokens;
+
+#endif
@@ -9,7 +9,7 @@
 #include "cool.h"
 #include "stringtab.h"
 #define yylineno curr_lineno;
-extern int yylineno;
+extern parser_local int yylineno;
 
 inline Boolean copy_Boolean(Boolean b) {return b; }
 inline void assert_Boolean(Boolean) {}
@@ -33,6 +33,9 @@ typedef Expression_class *Expression;
 class Case_class;
 typedef Case_class *Case;
 
+class AstCensus;
+class AstWriter;
+
 typedef list_node<Class_> Classes_class;
 typedef Classes_class *Classes;
 typedef list_node<Feature> Features_class;
@@ -45,48 +48,70 @@ typedef list_node<Case> Cases_class;
 typedef Cases_class *Cases;
 
 #define Program_EXTRAS                          \
-virtual void dump_with_types(ostream&, int) = 0; 
+virtual Classes get_classes() = 0;              \
+virtual void dump_with_types(ostream&, int) = 0; \
+virtual void census(AstCensus&, int) = 0;       \
+virtual void dump_binary(AstWriter&) = 0;
 
 
 
 #define program_EXTRAS                          \
-void dump_with_types(ostream&, int);            
+Classes get_classes() { return classes; }       \
+void dump_with_types(ostream&, int);            \
+void census(AstCensus&, int);                   \
+void dump_binary(AstWriter&);
 
 #define Class__EXTRAS                   \
 virtual Symbol get_filename() = 0;      \
-virtual void dump_with_types(ostream&,int) = 0; 
+virtual void dump_with_types(ostream&,int) = 0; \
+virtual void census(AstCensus&, int) = 0;       \
+virtual void dump_binary(AstWriter&) = 0;
 
 
 #define class__EXTRAS                                 \
 Symbol get_filename() { return filename; }             \
-void dump_with_types(ostream&,int);                    
+void dump_with_types(ostream&,int);                    \
+void census(AstCensus&, int);                          \
+void dump_binary(AstWriter&);
 
 
 #define Feature_EXTRAS                                        \
-virtual void dump_with_types(ostream&,int) = 0; 
+virtual void dump_with_types(ostream&,int) = 0;               \
+virtual void census(AstCensus&, int) = 0;                     \
+virtual void dump_binary(AstWriter&) = 0;
 
 
 #define Feature_SHARED_EXTRAS                                       \
-void dump_with_types(ostream&,int);    
+void dump_with_types(ostream&,int);                                 \
+void census(AstCensus&, int);                                       \
+void dump_binary(AstWriter&);
 
 
 
 
 
 #define Formal_EXTRAS                              \
-virtual void dump_with_types(ostream&,int) = 0;
+virtual void dump_with_types(ostream&,int) = 0;    \
+virtual void census(AstCensus&, int) = 0;          \
+virtual void dump_binary(AstWriter&) = 0;
 
 
 #define formal_EXTRAS                           \
-void dump_with_types(ostream&,int);
+void dump_with_types(ostream&,int);             \
+void census(AstCensus&, int);                   \
+void dump_binary(AstWriter&);
 
 
 #define Case_EXTRAS                             \
-virtual void dump_with_types(ostream& ,int) = 0;
+virtual void dump_with_types(ostream& ,int) = 0; \
+virtual void census(AstCensus&, int) = 0;       \
+virtual void dump_binary(AstWriter&) = 0;
 
 
 #define branch_EXTRAS                                   \
-void dump_with_types(ostream& ,int);
+void dump_with_types(ostream& ,int);                    \
+void census(AstCensus&, int);                           \
+void dump_binary(AstWriter&);
 
 
 #define Expression_EXTRAS                    \
@@ -94,13 +119,17 @@ Symbol type;                                 \
 Symbol get_type() { return type; }           \
 Expression set_type(Symbol s) { type = s; return this; } \
 virtual void dump_with_types(ostream&,int) = 0;  \
+virtual void census(AstCensus&, int) = 0;    \
+virtual void dump_binary(AstWriter&) = 0;    \
 void dump_type(ostream&, int);               \
 Expression_class() { type = (Symbol) NULL; }
 
 
 
 #define Expression_SHARED_EXTRAS           \
-void dump_with_types(ostream&,int); 
+void dump_with_types(ostream&,int);        \
+void census(AstCensus&, int);              \
+void dump_binary(AstWriter&);
 
 
 #endif
@@ -0,0 +1,77 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _INCREMENTAL_LEX_H_
+#define _INCREMENTAL_LEX_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  incremental-lex.h
+//
+//  The tokens of a COOL source that is being edited, as in an editor:
+//  after each edit, only the tokens around it are scanned again.
+//
+//  Scanning restarts at the end of the last token that ends before the
+//  edit.  The scanner is always in its initial state at the end of a
+//  token, never inside a string or a comment, since a string constant
+//  is one token and a comment lies between tokens; a comment or string
+//  that the edit is in, or that the edit opens or closes, is therefore
+//  scanned again whole.  A token is taken to depend on its own text and
+//  on the one byte after it, which is true of the tokens of COOL.
+//
+//  Scanning stops when it starts a token after the edit at the place
+//  where a token of the old text started.  Both scans are then at the
+//  start of a token, in the initial state, with the same text ahead,
+//  so the rest of the old tokens are the rest of the new ones, moved by
+//  the change in length.  If no such token comes, it goes to the end.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <vector>
+#include "cool-parse.h"
+#include "line-index.h"
+
+//
+// A token and where it is in the text.
+//
+struct lexed_token {
+  int token;
+  YYSTYPE value;
+  size_t start, end;              // offsets of it and of the byte after it
+};
+
+class incremental_lexer {
+private:
+  const char *name;
+  std::vector<char> text;         // followed by the two NULs flex needs
+  std::vector<lexed_token> toks;
+  line_index lines;
+  int scanned;
+
+  size_t size() const { return text.size() - 2; }
+
+public:
+  // scan all of the "size" bytes of "source"; "name" is its file name
+  incremental_lexer(const char *source, size_t size, const char *name);
+
+  // replace [start, end) of the text with the "size" bytes of "source",
+  // and return the tokens of the new text
+  const std::vector<lexed_token>& edit(size_t start, size_t end,
+				       const char *source, size_t size);
+
+  const std::vector<lexed_token>& tokens() const { return toks; }
+
+  // the line of a token, as the scanner would count it (line-index.h),
+  // and the column it starts at
+  int line(const lexed_token& t) const   { return lines.line(t.end); }
+  int column(const lexed_token& t) const { return lines.column(t.start); }
+
+  // how many tokens the last edit, or the first scan, scanned
+  int tokens_scanned() const { return scanned; }
+};
+
+#endif
@@ -0,0 +1,52 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _LINE_INDEX_H_
+#define _LINE_INDEX_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  line-index.h
+//
+//  Where the lines of a file begin, so that a position in the file can
+//  be turned into a line and column when one is wanted, rather than
+//  the scanner counting newlines in every rule that can match one.
+//
+//  A position is a byte offset into the text.  A newline belongs to the
+//  line it ends, so the offset just past a token gives the line the
+//  scanner would have counted to after it: that of the token's last
+//  character, or the next line for a token that ends with a newline
+//  (an unterminated string constant).
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <vector>
+
+class line_index {
+private:
+  std::vector<size_t> starts;     // offset of the first byte of each line
+
+public:
+  // index "size" bytes of "text"
+  void build(const char *text, size_t size);
+
+  // after [start, old_end) of the text has been replaced by the
+  // "size" bytes of "text"
+  void splice(size_t start, size_t old_end, const char *text, size_t size);
+
+  int lines() const { return starts.size(); }
+
+  // the line of "offset", counting from 1; "from" is the line of an
+  // earlier offset, or 1, and the search goes forward from it, so that
+  // the tokens of a file taken in order cost one step per line
+  int line(size_t offset, int from = 1) const;
+
+  // the column of "offset" in its line, counting from 1
+  int column(size_t offset) const;
+};
+
+#endif
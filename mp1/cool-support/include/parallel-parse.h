@@ -0,0 +1,34 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _PARALLEL_PARSE_H_
+#define _PARALLEL_PARSE_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  parallel-parse.h
+//
+//  Parsing several COOL source files at once, for frontend -j.  Each
+//  file is scanned and parsed on its own, as a job of a work_pool, and
+//  the classes of all of them are put together in command-line order;
+//  the lex and parse errors of each file are printed after those of the
+//  files before it.  The result does not depend on the number of
+//  threads or on which thread parsed which file.  It differs from that
+//  of a single parse only in that an error in one file does not end the
+//  parse of the files after it.
+//
+//  This needs objects built with PARALLEL_PARSE (see tree.h).  Each
+//  thread scans with a scanner instance of its own (cool-scanner.h), so
+//  scanning, parsing, building the trees and interning all run in
+//  parallel.
+//
+//////////////////////////////////////////////////////////////////////
+
+// parse "files" on up to "nthreads" threads, leaving the program and
+// the number of errors in this thread's ast_root and omerrs
+void parse_files_parallel(char **files, int nfiles, int nthreads);
+
+#endif
@@ -0,0 +1,101 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _PHASE_TIMER_H_
+#define _PHASE_TIMER_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  phase-timer.h
+//
+//  Where the compile time goes.  With -P (or -J file) every phase
+//  driver reports, for each phase and for the finer scopes inside
+//  them, how often it was entered and the totals of
+//
+//     wall time               CLOCK_MONOTONIC
+//     CPU time                of the thread that ran the scope
+//     peak RSS growth         ru_maxrss at the end less at the start
+//     allocations             calls to operator new, and their bytes,
+//                             with PHASE_TIMING
+//
+//  -P prints a table on cerr at exit; -J writes the same numbers to a
+//  file as JSON.  A scope nested in another is shown under the first
+//  one it was entered in, and its numbers are part of its parent's.
+//  Scopes still open when exit is called, as when a phase gives up
+//  on errors, end then, before the report.
+//
+//  A phase_scope tests time_phases and does nothing else when it is
+//  off.  That is cheap for a phase, but not on hot paths such as
+//  add_string, so the scopes there are inner_scopes, which time only
+//  when the compiler is built with -DPHASE_TIMING (make
+//  TIMING=-DPHASE_TIMING) and are empty otherwise.  The replacement of
+//  operator new that counts allocations is built only then too.
+//
+//////////////////////////////////////////////////////////////////////
+
+extern int time_phases;           // -P or -J (handle_flags.cc)
+
+//
+// The totals of one phase or scope, over all the times it was entered.
+//
+struct phase_timer {
+  const char *name;
+  phase_timer *parent;            // enclosing scope when first entered
+  phase_timer *next;              // in order of first use
+  bool used;
+  long calls;
+  long wall_ns, cpu_ns;
+  long rss_kb;
+  long allocs, alloc_bytes;
+
+  phase_timer(const char *n) : name(n), parent(0), next(0), used(false),
+    calls(0), wall_ns(0), cpu_ns(0), rss_kb(0), allocs(0), alloc_bytes(0) { }
+};
+
+//
+// The phases of the compiler and the scopes measured inside them.
+//
+extern phase_timer lex_phase;      // scanning COOL source; part of parse
+                                   // when the parser calls the scanner
+extern phase_timer parse_phase;    // cool_yyparse, reading tokens if piped
+extern phase_timer load_phase;     // reading a text or binary AST
+extern phase_timer dump_phase;     // printing the AST
+extern phase_timer semant_phase;
+extern phase_timer cgen_phase;
+extern phase_timer intern_scope;   // StringTable::add_string
+extern phase_timer symtab_scope;   // SymbolTable operations
+                                   // (both inner_scopes)
+
+class phase_scope {
+private:
+  phase_timer *timer;             // NULL when not timing
+  phase_scope *outer;             // scope this one is nested in
+  long wall, cpu, rss, allocs, alloc_bytes;
+
+  void start();
+  void stop();
+  friend void end_open_scopes();
+
+public:
+  phase_scope(phase_timer& t) : timer(time_phases ? &t : 0)
+    { if (timer) start(); }
+  ~phase_scope()
+    { if (timer) stop(); }
+};
+
+#ifdef PHASE_TIMING
+typedef phase_scope inner_scope;
+#else
+class inner_scope {
+public:
+  inner_scope(phase_timer&) { }
+};
+#endif
+
+// called by handle_flags for -P and -J; the report is made at exit
+void time_phases_until_exit(const char *program, const char *json_file);
+
+#endif
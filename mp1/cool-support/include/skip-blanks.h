@@ -0,0 +1,40 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _SKIP_BLANKS_H_
+#define _SKIP_BLANKS_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  skip-blanks.h
+//
+//  Skipping what is not a token: white space, -- comments and nested
+//  (* *) comments, which are most of the bytes of a typical COOL file.
+//  A DFA takes a transition for each of those bytes; these look at 16
+//  at a time for the few bytes that can end the run, so the scanner's
+//  rules are left with the real tokens.
+//
+//  Each takes the text from "p" up to "end", the end of the input, and
+//  returns where the run ends.  They do not count the newlines they
+//  pass: a scanner with its input in memory, as the whole-file input of
+//  scan-input.h and cool-scanner.h has it, finds the line of a token
+//  from where it is in the text (line-index.h).
+//
+//////////////////////////////////////////////////////////////////////
+
+// skip COOL white space: blank, \n, \f, \r, \t and \v
+const char *skip_white_space(const char *p, const char *end);
+
+// skip the rest of a -- comment; returns at the newline that ends it,
+// which is not skipped, or at "end"
+const char *skip_line_comment(const char *p, const char *end);
+
+// skip the text of (* *) comments with "depth" of them open, as after
+// their (*; returns after the *) that closes the outermost, with depth
+// 0, or at "end" with depth still above 0 if the input ends first
+const char *skip_block_comment(const char *p, const char *end, int& depth);
+
+#endif
@@ -0,0 +1,43 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _SOURCE_SCAN_H_
+#define _SOURCE_SCAN_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  source-scan.h
+//
+//  Scanning COOL source in the same process as the parser, for the
+//  frontend and coolc drivers.  The scanner is the flex scanner of
+//  cool-lex.cc, compiled for these drivers with its line number and
+//  token value renamed to scan_lineno and scan_yylval (see the
+//  Makefile), so that it can run on a thread of its own.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "cool-parse.h"
+#include "cool-scanner.h"
+
+// scan these files one after the other, as one token stream; stdin if
+// there are none
+void scan_files(char **files, int nfiles);
+
+// the next token, with cool_yylval, curr_lineno and curr_filename set
+// for it as tokens-lex sets them; 0 after the last file.  The tokens
+// are scanned a batch at a time, so the scanner may be ahead of the
+// token returned by up to token_batch tokens.
+int scan_token();
+
+// scan up to "max" tokens of the files into "tokens", the last of them
+// 0 if the files end; returns how many
+int scan_batch(scanned_token *tokens, int max);
+
+// run cool_yyparse on the tokens of the files, scanning them on this
+// thread or, if "threaded", on a thread of its own
+void parse_files(bool threaded);
+
+#endif
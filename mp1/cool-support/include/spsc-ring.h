@@ -0,0 +1,68 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _SPSC_RING_H_
+#define _SPSC_RING_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  spsc-ring.h
+//
+//  A fixed-size ring buffer for handing values from one producer
+//  thread to one consumer thread without locks.  Each side owns one
+//  index and only reads the other's; the release store of an index
+//  publishes the slots before it, and the matching acquire load makes
+//  them visible.  A side that finds the ring full (or empty) yields
+//  until the other catches up, so it also behaves on a single core.
+//
+//  close() lets a consumer that stops early release a producer waiting
+//  on a full ring; push then returns false.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <thread>
+
+template <class T, unsigned N>
+class spsc_ring {
+private:
+  static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+
+  T slots[N];
+  alignas(64) std::atomic<unsigned> head;   // next slot to pop
+  alignas(64) std::atomic<unsigned> tail;   // next slot to push
+  alignas(64) std::atomic<bool> closed;
+
+public:
+  spsc_ring() : head(0), tail(0), closed(false) { }
+
+  bool push(const T& v)
+  {
+    unsigned t = tail.load(std::memory_order_relaxed);
+    while (t - head.load(std::memory_order_acquire) == N) {
+      if (closed.load(std::memory_order_relaxed))
+	return false;
+      std::this_thread::yield();
+    }
+    slots[t % N] = v;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  T pop()
+  {
+    unsigned h = head.load(std::memory_order_relaxed);
+    while (tail.load(std::memory_order_acquire) == h)
+      std::this_thread::yield();
+    T v = slots[h % N];
+    head.store(h + 1, std::memory_order_release);
+    return v;
+  }
+
+  void close()                     { closed.store(true); }
+};
+
+#endif
@@ -0,0 +1,67 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _STRING_CONST_H_
+#define _STRING_CONST_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  string-const.h
+//
+//  Scanning a COOL string constant in the scanner's input buffer.
+//
+//  The usual scanner has a start condition for strings, with a rule per
+//  character or escape that appends to string_buf, and interns
+//  string_buf at the closing quote.  scan_string_const takes the text
+//  of the whole constant instead and looks only for the characters
+//  that end a run of plain text: \ " newline and NUL.  A constant
+//  without escapes, which is most of them, is interned straight from
+//  the input; only one with escapes is copied, into a buffer of its
+//  own on the stack.  With the whole-file input of scan-input.h the
+//  input is the file itself, so a plain constant is never copied before
+//  it reaches stringtable.
+//
+//  In cool.flex one rule matches the whole constant and hands it over:
+//
+//      \"([^"\\\n]|\\(.|\n))*["\n]?   {
+//          string_const s;
+//          scan_string_const(yytext + 1, yytext + yyleng, s);
+//          curr_lineno += s.newlines;
+//          cool_yylval = s.value;
+//          return s.token;
+//      }
+//
+//  The errors, their order and the line counting are those of the
+//  reference lexer: an unescaped newline ends the constant with
+//  "Unterminated string constant" and the end of the input with "EOF in
+//  string constant"; otherwise a NUL, escaped or not, makes it "String
+//  contains null character.", and more than MAX_STR_CONST - 1
+//  characters after escapes makes it "String constant too long".
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "cool-parse.h"
+
+#ifndef MAX_STR_CONST
+#define MAX_STR_CONST 1025   // as in cool.flex; includes the final NUL
+#endif
+
+struct string_const {
+  int token;                      // STR_CONST or ERROR
+  YYSTYPE value;                  // symbol in stringtable, or error_msg
+  int newlines;                   // lines the constant ends below its start
+};
+
+// scan the constant whose text after the opening quote begins at "p",
+// in input that ends at "end"; returns where it ends: after the closing
+// quote, after the newline that ended it, or at "end"
+const char *scan_string_const(const char *p, const char *end,
+			      string_const& s);
+
+// the first \ " newline or NUL in [p, end), or "end" if there is none
+const char *find_string_special(const char *p, const char *end);
+
+#endif
@@ -140,4 +140,14 @@ public:
 extern IdTable idtable;
 extern IntTable inttable;
 extern StrTable stringtable;
+
+//
+// A program that adds strings to the tables from more than one thread
+// (frontend -L) calls share_string_tables before it starts the threads;
+// add_string then holds a lock while it searches and extends a table.
+//
+extern bool string_tables_shared;
+void share_string_tables();
+void lock_string_tables();
+void unlock_string_tables();
 #endif
@@ -9,6 +9,7 @@
 #define min(a,b) (a > b ? b : a)
 
 #include "stringtab.h"
+#include "phase-timer.h"
 #include <stdio.h>
 
 //
@@ -31,13 +32,22 @@ Elem *StringTable<Elem>::add_string(const char *s)
 template <class Elem>
 Elem *StringTable<Elem>::add_string(const char *s, int maxchars)
 {
-  int len = min((int) strlen(s),maxchars);
-  for(List<Elem> *l = tbl; l; l = l->tl())
+  inner_scope timing(intern_scope);
+  int len = strnlen(s,maxchars);     // s need not end within maxchars
+  Elem *e = NULL;
+
+  if (string_tables_shared)
+    lock_string_tables();
+  for(List<Elem> *l = tbl; l && !e; l = l->tl())
     if (l->hd()->equal_string(s,len))
-      return l->hd();
+      e = l->hd();
 
-  Elem *e = new Elem(s,len,index++);
-  tbl = new List<Elem>(e, tbl);
+  if (!e) {
+    e = new Elem(s,len,index++);
+    tbl = new List<Elem>(e, tbl);
+  }
+  if (string_tables_shared)
+    unlock_string_tables();
   return e;
 }
 
@@ -15,6 +15,7 @@
 #define _SYMTAB_H_
 
 #include "list.h"
+#include "phase-timer.h"
 
 // added to prevent clash with llvm::SymbolTable
 namespace cool
@@ -101,6 +102,7 @@ public:
 
    void enterscope()
    {
+       inner_scope timing(symtab_scope);
        // The cast of NULL is required for template instantiation to work
        // correctly.
        tbl = new ScopeList((Scope *) NULL, tbl);
@@ -109,6 +111,7 @@ public:
    // Pop the first scope off of the symbol table.
    void exitscope()
    {
+       inner_scope timing(symtab_scope);
        // It is an error to exit a scope that doesn't exist.
        if (tbl == NULL) {
 	   fatal_error("exitscope: Can't remove scope from an empty symbol table.");
@@ -119,6 +122,7 @@ public:
    // Add an item to the symbol table.
    ScopeEntry *addid(SYM s, DAT *i)
    {
+       inner_scope timing(symtab_scope);
        // There must be at least one scope to add a symbol.
        if (tbl == NULL) fatal_error("addid: Can't add a symbol without a scope.");
        ScopeEntry * se = new ScopeEntry(s,i);
@@ -132,6 +136,7 @@ public:
 
    DAT * lookup(SYM s)
    {
+       inner_scope timing(symtab_scope);
        for(ScopeList *i = tbl; i != NULL; i=i->tl()) {
 	   for( Scope *j = i->hd(); j != NULL; j = j->tl()) {
 	       if (s == j->hd()->get_id()) {
@@ -146,6 +151,7 @@ public:
    // 's'.  If found, return the information field.  If not return NULL.
    DAT *probe(SYM s)
    {
+       inner_scope timing(symtab_scope);
        if (tbl == NULL) {
 	   fatal_error("probe: No scope in symbol table.");
        }
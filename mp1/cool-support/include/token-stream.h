@@ -0,0 +1,79 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _TOKEN_STREAM_H_
+#define _TOKEN_STREAM_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  token-stream.h
+//
+//  A binary form of the token stream the lexer hands to the parser,
+//  written by the lexer with -B instead of the "#line NAME value" text
+//  of dump_cool_token.  All numbers are unsigned LEB128 varints and all
+//  strings are a length followed by the bytes.
+//
+//     header   0x7f 'C' 'T' 'O' 'K' version
+//     records  one per token or file name, each starting with a code:
+//              0      a file name (the "#name" line of the text form):
+//                     the name as a string
+//              token  the change in line number since the previous
+//                     token (zigzag encoded), then the value the token
+//                     carries according to cool-tokens.h:
+//                       symbols   0 and the string the first time a
+//                                 string of that table (identifiers,
+//                                 integers, strings) is sent, after
+//                                 that its 1-based position in it
+//                       booleans  0 or 1
+//                       errors    the message as a string
+//
+//  Each identifier, integer and string constant is therefore sent and
+//  interned once, and the reader never unescapes anything.  The parser
+//  reads either form; next_cool_token tells them apart by the first
+//  byte.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <stdio.h>
+#include "cool-parse.h"
+
+#define TOKEN_STREAM_VERSION 1
+
+class TokenWriter {
+private:
+  enum { ID_TABLE, INT_TABLE, STR_TABLE, NTABLES };
+
+  ostream& stream;
+  std::string record;                      // the record being built
+  std::map<Symbol, int> index[NTABLES];    // symbol -> 1-based position
+  int line;                                // line of the previous token
+
+  void number(unsigned long n);
+  void string(const char *s, int len);
+  void symbol(int table, Symbol s);
+
+public:
+  TokenWriter(ostream& s);                 // writes the header
+  void name(const char *filename);
+  void token(int lineno, int token, YYSTYPE yylval);
+};
+
+//
+// The parser's lexer.  It reads the token stream from the file given
+// to open_token_stream, in either form, setting cool_yylval,
+// curr_lineno and curr_filename as tokens-lex does.  Malformed binary
+// input is a fatal error.
+//
+// A driver that scans COOL source in the same process (frontend-phase.cc)
+// instead sets a token source, which next_cool_token calls directly.
+//
+void open_token_stream(FILE *f);
+void set_token_source(int (*source)());
+int next_cool_token();
+
+#endif
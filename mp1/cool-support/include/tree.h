@@ -18,6 +18,20 @@
 #include "stringtab.h"
 #include "cool-io.h"
 
+//
+// The state the parser keeps in globals -- the line number and file name
+// of the current token, its value, the tree built and the error count --
+// is declared parser_local.  The objects of a driver that parses several
+// files at once (frontend -j, see parallel-parse.cc) are built with
+// PARALLEL_PARSE, which gives each thread its own copy; everywhere else
+// they are ordinary globals.
+//
+#ifdef PARALLEL_PARSE
+#define parser_local thread_local
+#else
+#define parser_local
+#endif
+
 /////////////////////////////////////////////////////////////////////
 //
 //  tree_node
@@ -98,6 +112,12 @@ public:
 //     "len" is set to the length of the list.  This method is used internally
 //     by the APS package to efficiently traverse the list representation.  
 //
+//     int shape(list_shape &s);
+//     Adds the number of nil, single and append cells of the list, and the
+//     bytes they occupy, to "s".  Returns the height of the tree of
+//     append_node cells: a list built by appending one element at a time
+//     is left-deep and has height len()-1, a balanced one about log2(len()).
+//
 //     static list_node<Elem> *nil();
 //     static list_node<Elem> *single(Elem);
 //     static list_node<Elem> *append(list_node<Elem> *, list_node<Elem> *);
@@ -112,6 +132,11 @@ public:
 //
 //////////////////////////////////////////////////////////////////////////////
 
+struct list_shape {
+    int nils, singles, appends;  // cells of each kind
+    long bytes;                  // storage held by the cells
+};
+
 template <class Elem> class list_node : public tree_node {
 public:
     tree_node *copy()            { return copy_list(); }
@@ -126,14 +151,13 @@ public:
     virtual list_node<Elem> *copy_list() = 0;
     virtual int len() = 0;
     virtual Elem nth_length(int n, int &len) = 0;
+    virtual int shape(list_shape &s) = 0;
 
     static list_node<Elem> *nil();
     static list_node<Elem> *single(Elem);
     static list_node<Elem> *append(list_node<Elem> *l1,list_node<Elem> *l2);
 };
 
-const char *pad(int n);
-
 extern int info_size;
 
 template <class Elem> class nil_node : public list_node<Elem> {
@@ -141,6 +165,7 @@ public:
     list_node<Elem> *copy_list();
     int len();
     Elem nth_length(int n, int &len);
+    int shape(list_shape &s);
     void dump(ostream& stream, int n);
 };
 
@@ -153,6 +178,7 @@ public:
     list_node<Elem> *copy_list();
     int len();
     Elem nth_length(int n, int &len);
+    int shape(list_shape &s);
     void dump(ostream& stream, int n);
 };
 
@@ -168,6 +194,7 @@ public:
     list_node<Elem> *copy_list();
     int len();
     Elem nth_length(int n, int &len);
+    int shape(list_shape &s);
     void dump(ostream& stream, int n);
 };
 
@@ -246,6 +273,21 @@ template <class Elem> Elem nil_node<Elem>::nth_length(int, int &len)
 }
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// nil_node::shape
+//
+// count this cell; a nil list has no append cells
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> int nil_node<Elem>::shape(list_shape &s)
+{
+    s.nils++;
+    s.bytes += sizeof(*this);
+    return 0;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // nil_node::dump
@@ -302,6 +344,21 @@ template <class Elem> Elem single_list_node<Elem>::nth_length(int n, int &len)
 }
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// single_list_node::shape
+//
+// count this cell; a single list has no append cells
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> int single_list_node<Elem>::shape(list_shape &s)
+{
+    s.singles++;
+    s.bytes += sizeof(*this);
+    return 0;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // single_list_node::dump
@@ -361,6 +418,23 @@ template <class Elem> Elem append_node<Elem>::nth_length(int n, int &len)
 }
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// append_node::shape
+//
+// count this cell and both halves; return the height of the append tree
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> int append_node<Elem>::shape(list_shape &s)
+{
+    s.appends++;
+    s.bytes += sizeof(*this);
+    int l = some->shape(s);
+    int r = rest->shape(s);
+    return 1 + (l > r ? l : r);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // append_node::dump
@@ -12,8 +12,8 @@
 
 extern const char *cool_token_to_string(int tok);
 extern void print_cool_token(int tok);
+extern void print_cool_token(ostream& out, int tok);
 extern void fatal_error(char *);
 extern void print_escaped_string(ostream& str, const char *s);
-extern const char *pad(int);
 
 #endif
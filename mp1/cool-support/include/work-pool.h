@@ -0,0 +1,52 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _WORK_POOL_H_
+#define _WORK_POOL_H_
+
+//////////////////////////////////////////////////////////////////////
+//
+//  work-pool.h
+//
+//  Runs a batch of independent jobs on a number of threads, by work
+//  stealing.  The jobs are dealt out in turn to one queue per thread,
+//  in the order given, so giving the biggest first spreads them evenly.
+//  Each thread takes jobs from the back of its own queue; when that is
+//  empty it steals from the front of another's, so a thread that drew
+//  short jobs takes over the rest of a thread that drew long ones.  The
+//  calling thread is one of the workers.
+//
+//  Jobs do not add jobs, so a thread that finds every queue empty is
+//  done.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class work_pool {
+private:
+  struct queue {
+    std::mutex lock;
+    std::deque<int> jobs;
+  };
+
+  int nthreads;
+  std::vector<queue> queues;
+
+  bool take(int self, int& job);
+  void work(int self, const std::function<void(int)>& run);
+
+public:
+  work_pool(int threads);
+
+  // run(j) for each j in "jobs"; returns when all have finished
+  void run(const std::vector<int>& jobs, const std::function<void(int)>& run);
+};
+
+#endif
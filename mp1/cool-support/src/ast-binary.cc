@@ -0,0 +1,814 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  ast-binary.cc
+//
+//  Writer and reader for the binary AST format described in
+//  ast-binary.h.  dump_binary is a recursive traversal of the tree in
+//  the style of dump_with_types (see dumptype.cc); the reader is a
+//  recursive descent over the bytes that rebuilds the tree with the
+//  usual constructor functions, setting curr_lineno before each one
+//  exactly as ast-parse does.  It runs once per class, when the class
+//  is first fetched from the program's lazy_class_list.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cool-tree.h"
+#include "ast-binary.h"
+
+extern parser_local int curr_lineno;
+
+static const char ast_magic[] = { 0x7f, 'C', 'A', 'S', 'T' };
+
+enum ast_tag {
+  AST_CLASS = 1, AST_METHOD, AST_ATTR, AST_FORMAL, AST_BRANCH,
+  AST_ASSIGN, AST_STATIC_DISPATCH, AST_DISPATCH, AST_COND, AST_LOOP,
+  AST_TYPCASE, AST_BLOCK, AST_LET, AST_PLUS, AST_SUB, AST_MUL, AST_DIVIDE,
+  AST_NEG, AST_LT, AST_EQ, AST_LEQ, AST_COMP, AST_INT_CONST, AST_BOOL_CONST,
+  AST_STRING_CONST, AST_NEW, AST_ISVOID, AST_NO_EXPR, AST_OBJECT
+};
+
+//////////////////////////////////////////////////////////////////
+//
+//  Writing
+//
+//////////////////////////////////////////////////////////////////
+
+void AstWriter::number(std::string& out, unsigned long n)
+{
+  while (n >= 0x80) {
+    out += (char) (n | 0x80);
+    n >>= 7;
+  }
+  out += (char) n;
+}
+
+void AstWriter::string(std::string& out, const char *s, int len)
+{
+  number(out, len);
+  out.append(s, len);
+}
+
+void AstWriter::symbol(int table, Symbol s)
+{
+  if (s == NULL) {
+    number(tree, 0);
+    return;
+  }
+  int &i = index[table][s];
+  if (i == 0) {
+    symbols[table].push_back(s);
+    i = symbols[table].size();
+  }
+  number(tree, i);
+}
+
+//
+// The classes are written one after the other, and where each starts is
+// noted for the index that finish() puts in front of them.
+//
+void AstWriter::program(tree_node *t, Classes classes)
+{
+  program_line = t->get_line_number();
+  for(int i = classes->first(); classes->more(i); i = classes->next(i)) {
+    class_offsets.push_back(tree.size());
+    classes->nth(i)->dump_binary(*this);
+  }
+}
+
+void AstWriter::node(int tag, tree_node *t)
+{
+  number(tree, tag);
+  number(tree, t->get_line_number());
+}
+
+void AstWriter::finish(ostream& stream)
+{
+  std::string head(ast_magic, sizeof(ast_magic));
+  head += (char) AST_BINARY_VERSION;
+  for (int t = 0; t < NTABLES; t++) {
+    number(head, symbols[t].size());
+    for (int i = 0; i < (int) symbols[t].size(); i++)
+      string(head, symbols[t][i]->get_string(), symbols[t][i]->get_len());
+  }
+  number(head, program_line);
+  number(head, class_offsets.size());
+  for (int i = 0; i < (int) class_offsets.size(); i++)
+    number(head, class_offsets[i]);
+  stream.write(head.data(), head.size());
+  stream.write(tree.data(), tree.size());
+  stream.flush();
+}
+
+void dump_binary_ast(ostream& stream, Program p)
+{
+  AstWriter w;
+  p->dump_binary(w);
+  w.finish(stream);
+}
+
+void program_class::dump_binary(AstWriter& w)
+{
+   w.program(this, classes);
+}
+
+void class__class::dump_binary(AstWriter& w)
+{
+   w.node(AST_CLASS, this);
+   w.id_symbol(name);
+   w.id_symbol(parent);
+   w.list(features);
+   w.string_symbol(filename);
+}
+
+void method_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_METHOD, this);
+   w.id_symbol(name);
+   w.list(formals);
+   w.id_symbol(return_type);
+   expr->dump_binary(w);
+}
+
+void attr_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_ATTR, this);
+   w.id_symbol(name);
+   w.id_symbol(type_decl);
+   init->dump_binary(w);
+}
+
+void formal_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_FORMAL, this);
+   w.id_symbol(name);
+   w.id_symbol(type_decl);
+}
+
+void branch_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_BRANCH, this);
+   w.id_symbol(name);
+   w.id_symbol(type_decl);
+   expr->dump_binary(w);
+}
+
+void assign_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_ASSIGN, this);
+   w.id_symbol(name);
+   expr->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void static_dispatch_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_STATIC_DISPATCH, this);
+   expr->dump_binary(w);
+   w.id_symbol(type_name);
+   w.id_symbol(name);
+   w.list(actual);
+   w.id_symbol(type);
+}
+
+void dispatch_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_DISPATCH, this);
+   expr->dump_binary(w);
+   w.id_symbol(name);
+   w.list(actual);
+   w.id_symbol(type);
+}
+
+void cond_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_COND, this);
+   pred->dump_binary(w);
+   then_exp->dump_binary(w);
+   else_exp->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void loop_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_LOOP, this);
+   pred->dump_binary(w);
+   body->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void typcase_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_TYPCASE, this);
+   expr->dump_binary(w);
+   w.list(cases);
+   w.id_symbol(type);
+}
+
+void block_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_BLOCK, this);
+   w.list(body);
+   w.id_symbol(type);
+}
+
+void let_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_LET, this);
+   w.id_symbol(identifier);
+   w.id_symbol(type_decl);
+   init->dump_binary(w);
+   body->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void plus_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_PLUS, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void sub_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_SUB, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void mul_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_MUL, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void divide_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_DIVIDE, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void neg_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_NEG, this);
+   e1->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void lt_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_LT, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void eq_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_EQ, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void leq_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_LEQ, this);
+   e1->dump_binary(w);
+   e2->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void comp_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_COMP, this);
+   e1->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void int_const_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_INT_CONST, this);
+   w.int_symbol(token);
+   w.id_symbol(type);
+}
+
+void bool_const_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_BOOL_CONST, this);
+   w.boolean(val);
+   w.id_symbol(type);
+}
+
+void string_const_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_STRING_CONST, this);
+   w.string_symbol(token);
+   w.id_symbol(type);
+}
+
+void new__class::dump_binary(AstWriter& w)
+{
+   w.node(AST_NEW, this);
+   w.id_symbol(type_name);
+   w.id_symbol(type);
+}
+
+void isvoid_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_ISVOID, this);
+   e1->dump_binary(w);
+   w.id_symbol(type);
+}
+
+void no_expr_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_NO_EXPR, this);
+   w.id_symbol(type);
+}
+
+void object_class::dump_binary(AstWriter& w)
+{
+   w.node(AST_OBJECT, this);
+   w.id_symbol(name);
+   w.id_symbol(type);
+}
+
+//////////////////////////////////////////////////////////////////
+//
+//  Reading
+//
+//////////////////////////////////////////////////////////////////
+
+class AstReader {
+private:
+  const unsigned char *base, *tree, *p, *end;
+  std::vector<char> buffer;          // the input, unless it is mapped
+  std::vector<Symbol> symbols[3];
+  int program_line;
+  std::vector<unsigned long> class_offsets;
+
+  void open();
+
+  void malformed();
+  unsigned long number();
+  int line()                     { return (int) number(); }
+  Symbol symbol(int table);
+  Symbol id_symbol()             { return symbol(0); }
+  Symbol int_symbol()            { return symbol(1); }
+  Symbol string_symbol()         { return symbol(2); }
+  void expect(int tag);
+
+  Class_ class_node();
+  Feature feature_node();
+  Formal formal_node();
+  Case case_node();
+  Expression expression_node();
+  Features features_list();
+  Formals formals_list();
+  Expressions expressions_list();
+  Cases cases_list();
+
+public:
+  AstReader(const char *map, size_t len);
+  AstReader(FILE *f);
+  int get_program_line()         { return program_line; }
+  int class_count()              { return class_offsets.size(); }
+  Class_ class_at(int n);
+};
+
+void AstReader::malformed()
+{
+  cerr << "malformed binary AST\n";
+  exit(1);
+}
+
+unsigned long AstReader::number()
+{
+  unsigned long n = 0;
+  int shift = 0;
+  do {
+    if (p == end || shift > 56)
+      malformed();
+    n |= (unsigned long) (*p & 0x7f) << shift;
+    shift += 7;
+  } while (*p++ & 0x80);
+  return n;
+}
+
+Symbol AstReader::symbol(int table)
+{
+  unsigned long i = number();
+  if (i == 0)
+    return NULL;
+  if (i > symbols[table].size())
+    malformed();
+  return symbols[table][i-1];
+}
+
+void AstReader::expect(int tag)
+{
+  if ((int) number() != tag)
+    malformed();
+}
+
+//
+// The input is either a mapping of the whole file (which is never
+// unmapped; the tree does not point into it, but classes are decoded
+// from it for as long as the program runs) or a copy read from a pipe.
+//
+AstReader::AstReader(const char *map, size_t len)
+{
+  base = (const unsigned char *) map;
+  end = base + len;
+  open();
+}
+
+AstReader::AstReader(FILE *f)
+{
+  char chunk[1 << 16];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+    buffer.insert(buffer.end(), chunk, chunk + n);
+  base = (const unsigned char *) buffer.data();
+  end = base + buffer.size();
+  open();
+}
+
+//
+// The header, string sections and class index are decoded up front.
+// Strings are interned into the same tables ast-lex uses: identifiers
+// and types into idtable, integers into inttable, strings and file names
+// into stringtable.
+//
+void AstReader::open()
+{
+  p = base;
+  if ((size_t) (end - p) < sizeof(ast_magic) + 1 ||
+      memcmp(p, ast_magic, sizeof(ast_magic)) != 0 ||
+      p[sizeof(ast_magic)] != AST_BINARY_VERSION)
+    malformed();
+  p += sizeof(ast_magic) + 1;
+
+  std::string s;
+  for (int t = 0; t < 3; t++) {
+    unsigned long count = number();
+    for (unsigned long i = 0; i < count; i++) {
+      unsigned long n = number();
+      if (n > (unsigned long) (end - p))
+	malformed();
+      s.assign((const char *) p, n);
+      p += n;
+      switch (t) {
+      case 0: symbols[t].push_back(idtable.add_string(s.c_str(), n)); break;
+      case 1: symbols[t].push_back(inttable.add_string(s.c_str(), n)); break;
+      case 2: symbols[t].push_back(stringtable.add_string(s.c_str(), n)); break;
+      }
+    }
+  }
+
+  program_line = line();
+  unsigned long count = number();
+  for (unsigned long i = 0; i < count; i++)
+    class_offsets.push_back(number());
+  tree = p;
+  for (unsigned long i = 0; i < count; i++)
+    if (class_offsets[i] >= (unsigned long) (end - tree))
+      malformed();
+}
+
+//
+// Decoding sets curr_lineno for the constructors; since this can happen
+// at any point in a later phase, the phase's own value is put back.
+//
+Class_ AstReader::class_at(int n)
+{
+  int saved_lineno = curr_lineno;
+  p = tree + class_offsets[n];
+  Class_ c = class_node();
+  curr_lineno = saved_lineno;
+  return c;
+}
+
+Class_ AstReader::class_node()
+{
+  expect(AST_CLASS);
+  int l = line();
+  Symbol name = id_symbol();
+  Symbol parent = id_symbol();
+  Features features = features_list();
+  Symbol filename = string_symbol();
+  curr_lineno = l;
+  return class_(name, parent, features, filename);
+}
+
+Feature AstReader::feature_node()
+{
+  int tag = number();
+  int l = line();
+  Symbol name = id_symbol();
+  switch (tag) {
+  case AST_METHOD: {
+    Formals formals = formals_list();
+    Symbol return_type = id_symbol();
+    Expression expr = expression_node();
+    curr_lineno = l;
+    return method(name, formals, return_type, expr);
+  }
+  case AST_ATTR: {
+    Symbol type_decl = id_symbol();
+    Expression init = expression_node();
+    curr_lineno = l;
+    return attr(name, type_decl, init);
+  }
+  }
+  malformed();
+  return NULL;
+}
+
+Formal AstReader::formal_node()
+{
+  expect(AST_FORMAL);
+  int l = line();
+  Symbol name = id_symbol();
+  Symbol type_decl = id_symbol();
+  curr_lineno = l;
+  return formal(name, type_decl);
+}
+
+Case AstReader::case_node()
+{
+  expect(AST_BRANCH);
+  int l = line();
+  Symbol name = id_symbol();
+  Symbol type_decl = id_symbol();
+  Expression expr = expression_node();
+  curr_lineno = l;
+  return branch(name, type_decl, expr);
+}
+
+//
+// Children are read into locals first: the order in which function
+// arguments are evaluated is unspecified, and the fields must be consumed
+// in the order they were written.
+//
+Expression AstReader::expression_node()
+{
+  int tag = number();
+  int l = line();
+  Expression e = NULL;
+
+  switch (tag) {
+  case AST_ASSIGN: {
+    Symbol name = id_symbol();
+    Expression expr = expression_node();
+    curr_lineno = l;
+    e = assign(name, expr);
+    break;
+  }
+  case AST_STATIC_DISPATCH: {
+    Expression expr = expression_node();
+    Symbol type_name = id_symbol();
+    Symbol name = id_symbol();
+    Expressions actual = expressions_list();
+    curr_lineno = l;
+    e = static_dispatch(expr, type_name, name, actual);
+    break;
+  }
+  case AST_DISPATCH: {
+    Expression expr = expression_node();
+    Symbol name = id_symbol();
+    Expressions actual = expressions_list();
+    curr_lineno = l;
+    e = dispatch(expr, name, actual);
+    break;
+  }
+  case AST_COND: {
+    Expression pred = expression_node();
+    Expression then_exp = expression_node();
+    Expression else_exp = expression_node();
+    curr_lineno = l;
+    e = cond(pred, then_exp, else_exp);
+    break;
+  }
+  case AST_LOOP: {
+    Expression pred = expression_node();
+    Expression body = expression_node();
+    curr_lineno = l;
+    e = loop(pred, body);
+    break;
+  }
+  case AST_TYPCASE: {
+    Expression expr = expression_node();
+    Cases cases = cases_list();
+    curr_lineno = l;
+    e = typcase(expr, cases);
+    break;
+  }
+  case AST_BLOCK: {
+    Expressions body = expressions_list();
+    curr_lineno = l;
+    e = block(body);
+    break;
+  }
+  case AST_LET: {
+    Symbol identifier = id_symbol();
+    Symbol type_decl = id_symbol();
+    Expression init = expression_node();
+    Expression body = expression_node();
+    curr_lineno = l;
+    e = let(identifier, type_decl, init, body);
+    break;
+  }
+  case AST_PLUS:
+  case AST_SUB:
+  case AST_MUL:
+  case AST_DIVIDE:
+  case AST_LT:
+  case AST_EQ:
+  case AST_LEQ: {
+    Expression e1 = expression_node();
+    Expression e2 = expression_node();
+    curr_lineno = l;
+    switch (tag) {
+    case AST_PLUS:   e = plus(e1, e2); break;
+    case AST_SUB:    e = sub(e1, e2); break;
+    case AST_MUL:    e = mul(e1, e2); break;
+    case AST_DIVIDE: e = divide(e1, e2); break;
+    case AST_LT:     e = lt(e1, e2); break;
+    case AST_EQ:     e = eq(e1, e2); break;
+    default:         e = leq(e1, e2); break;
+    }
+    break;
+  }
+  case AST_NEG:
+  case AST_COMP:
+  case AST_ISVOID: {
+    Expression e1 = expression_node();
+    curr_lineno = l;
+    switch (tag) {
+    case AST_NEG:  e = neg(e1); break;
+    case AST_COMP: e = comp(e1); break;
+    default:       e = isvoid(e1); break;
+    }
+    break;
+  }
+  case AST_INT_CONST:
+    curr_lineno = l;
+    e = int_const(int_symbol());
+    break;
+  case AST_BOOL_CONST:
+    curr_lineno = l;
+    e = bool_const(number() != 0);
+    break;
+  case AST_STRING_CONST:
+    curr_lineno = l;
+    e = string_const(string_symbol());
+    break;
+  case AST_NEW:
+    curr_lineno = l;
+    e = new_(id_symbol());
+    break;
+  case AST_NO_EXPR:
+    curr_lineno = l;
+    e = no_expr();
+    break;
+  case AST_OBJECT:
+    curr_lineno = l;
+    e = object(id_symbol());
+    break;
+  default:
+    malformed();
+  }
+  Symbol type = id_symbol();
+  if (type)
+    e->set_type(type);
+  return e;
+}
+
+//
+// Lists are rebuilt the way ast-parse builds them: nil when empty,
+// otherwise a single list extended by appending one element at a time.
+//
+#define READ_LIST(list_type, phylum, read_elem)                      \
+list_type AstReader::phylum##_list()                                 \
+{                                                                    \
+  unsigned long n = number();                                        \
+  if (n == 0)                                                        \
+    return nil_##list_type();                                        \
+  list_type l = single_##list_type(read_elem());                     \
+  for (unsigned long i = 1; i < n; i++)                              \
+    l = append_##list_type(l, single_##list_type(read_elem()));      \
+  return l;                                                          \
+}
+
+READ_LIST(Features, features, feature_node)
+READ_LIST(Formals, formals, formal_node)
+READ_LIST(Expressions, expressions, expression_node)
+READ_LIST(Cases, cases, case_node)
+
+//
+// lazy_class_list is the Classes of a Program read from a binary AST.
+// It behaves like the lists built in tree.h, but nth_length decodes a
+// class the first time it is asked for and keeps it.
+//
+class lazy_class_list : public list_node<Class_> {
+private:
+  AstReader *reader;
+  std::vector<Class_> decoded;
+public:
+  lazy_class_list(AstReader *r) :
+    reader(r), decoded(r->class_count(), (Class_) NULL) { }
+  list_node<Class_> *copy_list();
+  int len()                      { return decoded.size(); }
+  Class_ nth_length(int n, int &len);
+  int shape(list_shape &s);
+  void dump(ostream& stream, int n);
+};
+
+Class_ lazy_class_list::nth_length(int n, int &len)
+{
+  len = decoded.size();
+  if (n < 0 || n >= len)
+    return NULL;
+  if (!decoded[n])
+    decoded[n] = reader->class_at(n);
+  return decoded[n];
+}
+
+list_node<Class_> *lazy_class_list::copy_list()
+{
+  Classes l = nil_Classes();
+  for (int i = 0; i < len(); i++)
+    l = append_Classes(l, single_Classes(nth(i)->copy_Class_()));
+  return l;
+}
+
+// the classes are held in one flat array, so there are no list cells
+int lazy_class_list::shape(list_shape &s)
+{
+  s.bytes += sizeof(*this) + decoded.capacity() * sizeof(Class_);
+  return 0;
+}
+
+// prints what the list ast-parse would have built prints
+void lazy_class_list::dump(ostream& stream, int n)
+{
+  int size = len();
+  if (size == 0) {
+    stream << pad(n) << "(nil)\n";
+  } else if (size == 1) {
+    nth(0)->dump(stream, n);
+  } else {
+    stream << pad(n) << "list\n";
+    for (int i = 0; i < size; i++)
+      nth(i)->dump(stream, n+2);
+    stream << pad(n) << "(end_of_list)\n";
+  }
+}
+
+bool is_binary_ast(FILE *f)
+{
+  int c = getc(f);
+  if (c == EOF)
+    return false;
+  ungetc(c, f);
+  return c == (unsigned char) ast_magic[0];
+}
+
+//
+// A regular file that has not been read from yet is mapped; anything
+// else (a pipe, a partly consumed file) is read into memory.
+//
+Program read_binary_ast(FILE *f)
+{
+  AstReader *r = NULL;
+  struct stat st;
+
+  if (fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode) &&
+      st.st_size > 0 && ftell(f) == 0) {
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (map != MAP_FAILED)
+      r = new AstReader((const char *) map, st.st_size);
+  }
+  if (!r)
+    r = new AstReader(f);
+
+  curr_lineno = r->get_program_line();
+  return program(new lazy_class_list(r));
+}
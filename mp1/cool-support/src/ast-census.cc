@@ -0,0 +1,308 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  ast-census.cc
+//
+//  census() is a recursive traversal of the AST in the style of
+//  dump_with_types (see dumptype.cc): every node records itself in an
+//  AstCensus together with its depth, then visits its children one
+//  level deeper.  Lists record their shape and then visit each element.
+//
+//  ast_census() runs the traversal from the root and prints the report.
+//  The parser and the AST readers call it when the -C flag is given.
+//
+//////////////////////////////////////////////////////////////////
+
+#include "cool-tree.h"
+#include "ast-census.h"
+
+void AstCensus::node(const char *kind, int bytes, int depth)
+{
+  kind_count &k = kinds[kind];
+  k.nodes++;
+  k.bytes += bytes;
+  if (depth >= (int) depths.size())
+    depths.resize(depth + 1, 0);
+  depths[depth]++;
+}
+
+void AstCensus::add_list(const char *phylum, int len, int height,
+                         list_shape &s)
+{
+  list_count &l = lists[phylum];
+  l.lists++;
+  l.elems += len;
+  l.cells += s.nils + s.singles + s.appends;
+  l.bytes += s.bytes;
+  if (len > 2 && height == len - 1)
+    l.left_deep++;
+  if (len > l.max_len) l.max_len = len;
+  if (height > l.max_height) l.max_height = height;
+
+  int bucket = 0;
+  while ((2 << bucket) <= len)
+    bucket++;
+  length_count &b = l.by_length[len ? bucket + 1 : 0];
+  b.lists++;
+  b.height_sum += height;
+  if (height > b.max_height) b.max_height = height;
+}
+
+void AstCensus::report(ostream& stream)
+{
+  long nodes = 0, bytes = 0;
+
+  stream << "AST census\n";
+  stream << "  " << std::left << setw(24) << "kind" << std::right
+         << setw(10) << "nodes" << setw(12) << "bytes" << "\n";
+  for (std::map<std::string, kind_count>::iterator i = kinds.begin();
+       i != kinds.end(); i++) {
+    stream << "  " << std::left << setw(24) << i->first << std::right
+           << setw(10) << i->second.nodes << setw(12) << i->second.bytes
+           << "\n";
+    nodes += i->second.nodes;
+    bytes += i->second.bytes;
+  }
+  stream << "  " << std::left << setw(24) << "total" << std::right
+         << setw(10) << nodes << setw(12) << bytes << "\n";
+
+  stream << "depth histogram\n";
+  stream << "  " << setw(6) << "depth" << setw(10) << "nodes" << "\n";
+  for (int d = 0; d < (int) depths.size(); d++)
+    stream << "  " << setw(6) << d << setw(10) << depths[d] << "\n";
+
+  stream << "list shapes (height of append_node tree against length)\n";
+  for (std::map<std::string, list_count>::iterator i = lists.begin();
+       i != lists.end(); i++) {
+    list_count &l = i->second;
+    stream << "  " << i->first << ": " << l.lists << " lists, "
+           << l.elems << " elements, " << l.cells << " cells, "
+           << l.bytes << " bytes, max length " << l.max_len
+           << ", max height " << l.max_height << ", "
+           << l.left_deep << " left-deep\n";
+    stream << "    " << setw(14) << "length" << setw(10) << "lists"
+           << setw(14) << "mean height" << setw(12) << "max height" << "\n";
+    for (std::map<int, length_count>::iterator j = l.by_length.begin();
+         j != l.by_length.end(); j++) {
+      length_count &b = j->second;
+      int lo = j->first ? 1 << (j->first - 1) : 0;
+      int hi = j->first ? (2 << (j->first - 1)) - 1 : 0;
+      std::string range = std::to_string(lo);
+      if (hi != lo)
+        range += "-" + std::to_string(hi);
+      stream << "    " << setw(14) << range << setw(10) << b.lists
+             << setw(14) << std::fixed << std::setprecision(1)
+             << (double) b.height_sum / b.lists
+             << setw(12) << b.max_height << "\n";
+    }
+  }
+}
+
+void ast_census(Program p, ostream& stream)
+{
+  AstCensus c;
+  p->census(c, 0);
+  c.report(stream);
+}
+
+template <class Elem>
+static void census_list(AstCensus& c, const char *phylum,
+                        list_node<Elem> *l, int n)
+{
+  c.list(phylum, l);
+  for(int i = l->first(); l->more(i); i = l->next(i))
+    l->nth(i)->census(c, n);
+}
+
+void program_class::census(AstCensus& c, int n)
+{
+   c.node("program_class", sizeof(*this), n);
+   census_list(c, "Classes", classes, n+1);
+}
+
+void class__class::census(AstCensus& c, int n)
+{
+   c.node("class__class", sizeof(*this), n);
+   census_list(c, "Features", features, n+1);
+}
+
+void method_class::census(AstCensus& c, int n)
+{
+   c.node("method_class", sizeof(*this), n);
+   census_list(c, "Formals", formals, n+1);
+   expr->census(c, n+1);
+}
+
+void attr_class::census(AstCensus& c, int n)
+{
+   c.node("attr_class", sizeof(*this), n);
+   init->census(c, n+1);
+}
+
+void formal_class::census(AstCensus& c, int n)
+{
+   c.node("formal_class", sizeof(*this), n);
+}
+
+void branch_class::census(AstCensus& c, int n)
+{
+   c.node("branch_class", sizeof(*this), n);
+   expr->census(c, n+1);
+}
+
+void assign_class::census(AstCensus& c, int n)
+{
+   c.node("assign_class", sizeof(*this), n);
+   expr->census(c, n+1);
+}
+
+void static_dispatch_class::census(AstCensus& c, int n)
+{
+   c.node("static_dispatch_class", sizeof(*this), n);
+   expr->census(c, n+1);
+   census_list(c, "Expressions", actual, n+1);
+}
+
+void dispatch_class::census(AstCensus& c, int n)
+{
+   c.node("dispatch_class", sizeof(*this), n);
+   expr->census(c, n+1);
+   census_list(c, "Expressions", actual, n+1);
+}
+
+void cond_class::census(AstCensus& c, int n)
+{
+   c.node("cond_class", sizeof(*this), n);
+   pred->census(c, n+1);
+   then_exp->census(c, n+1);
+   else_exp->census(c, n+1);
+}
+
+void loop_class::census(AstCensus& c, int n)
+{
+   c.node("loop_class", sizeof(*this), n);
+   pred->census(c, n+1);
+   body->census(c, n+1);
+}
+
+void typcase_class::census(AstCensus& c, int n)
+{
+   c.node("typcase_class", sizeof(*this), n);
+   expr->census(c, n+1);
+   census_list(c, "Cases", cases, n+1);
+}
+
+void block_class::census(AstCensus& c, int n)
+{
+   c.node("block_class", sizeof(*this), n);
+   census_list(c, "Expressions", body, n+1);
+}
+
+void let_class::census(AstCensus& c, int n)
+{
+   c.node("let_class", sizeof(*this), n);
+   init->census(c, n+1);
+   body->census(c, n+1);
+}
+
+void plus_class::census(AstCensus& c, int n)
+{
+   c.node("plus_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void sub_class::census(AstCensus& c, int n)
+{
+   c.node("sub_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void mul_class::census(AstCensus& c, int n)
+{
+   c.node("mul_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void divide_class::census(AstCensus& c, int n)
+{
+   c.node("divide_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void neg_class::census(AstCensus& c, int n)
+{
+   c.node("neg_class", sizeof(*this), n);
+   e1->census(c, n+1);
+}
+
+void lt_class::census(AstCensus& c, int n)
+{
+   c.node("lt_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void eq_class::census(AstCensus& c, int n)
+{
+   c.node("eq_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void leq_class::census(AstCensus& c, int n)
+{
+   c.node("leq_class", sizeof(*this), n);
+   e1->census(c, n+1);
+   e2->census(c, n+1);
+}
+
+void comp_class::census(AstCensus& c, int n)
+{
+   c.node("comp_class", sizeof(*this), n);
+   e1->census(c, n+1);
+}
+
+void int_const_class::census(AstCensus& c, int n)
+{
+   c.node("int_const_class", sizeof(*this), n);
+}
+
+void bool_const_class::census(AstCensus& c, int n)
+{
+   c.node("bool_const_class", sizeof(*this), n);
+}
+
+void string_const_class::census(AstCensus& c, int n)
+{
+   c.node("string_const_class", sizeof(*this), n);
+}
+
+void new__class::census(AstCensus& c, int n)
+{
+   c.node("new__class", sizeof(*this), n);
+}
+
+void isvoid_class::census(AstCensus& c, int n)
+{
+   c.node("isvoid_class", sizeof(*this), n);
+   e1->census(c, n+1);
+}
+
+void no_expr_class::census(AstCensus& c, int n)
+{
+   c.node("no_expr_class", sizeof(*this), n);
+}
+
+void object_class::census(AstCensus& c, int n)
+{
+   c.node("object_class", sizeof(*this), n);
+}
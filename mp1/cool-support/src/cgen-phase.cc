@@ -3,6 +3,9 @@
 #include <string.h>
 #include "cool-io.h"  //includes iostream
 #include "cool-tree.h"
+#include "ast-census.h"
+#include "ast-binary.h"
+#include "phase-timer.h"
 #include "cgen_gc.h"
 
 extern int optind;            // for option processing
@@ -12,6 +15,7 @@ FILE *ast_file = stdin;       // we read the AST from standard input
 extern int ast_yyparse(void); // entry point to the AST parser
 
 int cool_yydebug;     // not used, but needed to link with handle_flags
+extern int dump_census;       // -C: print AST statistics on cerr
 int curr_lineno;
 char *curr_filename;
 
@@ -21,6 +25,7 @@ int main(int argc, char *argv[]) {
   int firstfile_index;
 
   handle_flags(argc,argv);
+  buffer_cout();
   firstfile_index = optind;
 
   if (!out_filename && optind < argc) {   // no -o option
@@ -35,8 +40,17 @@ int main(int argc, char *argv[]) {
   // Don't touch the output file until we know that earlier phases of the
   // compiler have succeeded.
   //
-  ast_yyparse();
+  {
+    phase_scope timing(load_phase);
+    if (is_binary_ast(ast_file))
+      ast_root = read_binary_ast(ast_file);
+    else
+      ast_yyparse();
+  }
+  if (dump_census)
+    ast_census(ast_root, cerr);
 
+  phase_scope timing(cgen_phase);
   if (out_filename) {
       ofstream s(out_filename);
       if (!s) {
@@ -0,0 +1,106 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  cool-keywords.cc
+//
+//  The keyword hash of cool-keywords.h.
+//
+//  An identifier is folded to lower case by setting bit 0x20 of each
+//  character, which is exact for the letters, digits and underscores
+//  an identifier is made of.  The hash mixes the first two and the last
+//  characters with the length; the table is built from keywords[] when
+//  compiling, and the build fails if two keywords share a slot, so a
+//  change to either must keep the hash perfect.
+//
+//////////////////////////////////////////////////////////////////
+
+#include "cool-parse.h"
+#include "cool-keywords.h"
+
+struct keyword {
+  const char *name;
+  int len;
+  int token;
+};
+
+static constexpr keyword keywords[] = {
+  { "class",    5, CLASS },
+  { "else",     4, ELSE },
+  { "fi",       2, FI },
+  { "if",       2, IF },
+  { "in",       2, IN },
+  { "inherits", 8, INHERITS },
+  { "isvoid",   6, ISVOID },
+  { "let",      3, LET },
+  { "loop",     4, LOOP },
+  { "pool",     4, POOL },
+  { "then",     4, THEN },
+  { "while",    5, WHILE },
+  { "case",     4, CASE },
+  { "esac",     4, ESAC },
+  { "new",      3, NEW },
+  { "of",       2, OF },
+  { "not",      3, NOT },
+  { "true",     4, BOOL_CONST },
+  { "false",    5, BOOL_CONST },
+};
+
+static const int nkeywords = sizeof(keywords) / sizeof(keywords[0]);
+static const int min_len = 2, max_len = 8;
+static const int table_size = 32;
+
+static constexpr unsigned fold(char c)
+{
+  return (unsigned char) c | 0x20;
+}
+
+static constexpr unsigned hash(const char *text, int len)
+{
+  return (7 * fold(text[0]) + 9 * fold(text[1]) + 4 * fold(text[len - 1])
+	  + len) % table_size;
+}
+
+// for each hash, the index in keywords[] of the keyword with it, or -1
+struct keyword_table {
+  signed char slot[table_size];
+  bool perfect;
+};
+
+static constexpr keyword_table make_table()
+{
+  keyword_table t = { {}, true };
+  for (int h = 0; h < table_size; h++)
+    t.slot[h] = -1;
+  for (int k = 0; k < nkeywords; k++) {
+    unsigned h = hash(keywords[k].name, keywords[k].len);
+    if (t.slot[h] != -1)
+      t.perfect = false;
+    t.slot[h] = k;
+  }
+  return t;
+}
+
+static constexpr keyword_table table = make_table();
+static_assert(table.perfect, "two COOL keywords have the same hash");
+
+int cool_keyword(const char *text, int len)
+{
+  if (len < min_len || len > max_len)
+    return 0;
+  int k = table.slot[hash(text, len)];
+  if (k < 0 || keywords[k].len != len)
+    return 0;
+  const char *name = keywords[k].name;
+  for (int i = 0; i < len; i++)
+    if (fold(text[i]) != (unsigned char) name[i])
+      return 0;
+  // True and FALSE are type names
+  if (keywords[k].token == BOOL_CONST && text[0] != name[0])
+    return 0;
+  return keywords[k].token;
+}
@@ -0,0 +1,128 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  cool-scanner.cc
+//
+//  Handing out the scanner engines (see cool-scanner.h).  Each engine
+//  adds itself to the list when the program starts.  A file is read
+//  whole, in one read if it is a regular file (see scan-input.h), and
+//  its lines are indexed once for the line numbers of its tokens.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <condition_variable>
+#include <mutex>
+#include "cool-io.h"
+#include "scan-input.h"
+#include "cool-scanner.h"
+
+extern int yy_flex_debug;        // -l, for every engine
+
+static scanner_engine *engines;
+static std::mutex engines_lock;
+static std::condition_variable engine_free;
+
+scanner_engine::scanner_engine(int *lineno, YYSTYPE *yylval, int *debug,
+			       char **text, int *leng, int (*l)(),
+			       void (*s)(FILE *, char *, size_t), void (*f)())
+  : curr_lineno(lineno), cool_yylval(yylval), flex_debug(debug),
+    yytext(text), yyleng(leng), lex(l), start(s), finish(f),
+    next(engines), busy(false)
+{
+  engines = this;
+}
+
+cool_scanner::cool_scanner()
+  : engine(NULL), text(NULL), owned(NULL), indexed(false), line(1),
+    filename("<stdin>")
+{
+  std::unique_lock<std::mutex> hold(engines_lock);
+  if (!engines) {
+    cerr << "No scanner engines were built into this program\n";
+    exit(1);
+  }
+  for (;;) {
+    for (engine = engines; engine; engine = engine->next)
+      if (!engine->busy) {
+	engine->busy = true;
+	return;
+      }
+    engine_free.wait(hold);
+  }
+}
+
+cool_scanner::~cool_scanner()
+{
+  engine->finish();
+  free(owned);
+  {
+    std::lock_guard<std::mutex> hold(engines_lock);
+    engine->busy = false;
+  }
+  engine_free.notify_one();
+}
+
+void cool_scanner::open(FILE *f, const char *name)
+{
+  size_t size = 0;
+
+  engine->finish();
+  free(owned);
+  owned = text = read_all_text(f, size);
+  if (text == NULL) {
+    cerr << "out of memory reading " << name << "\n";
+    exit(1);
+  }
+  indexed = true;
+  lines.build(text, size);
+  line = 1;
+  filename = name;
+  *engine->flex_debug = yy_flex_debug;
+  engine->start(f, text, size);
+}
+
+void cool_scanner::open(char *t, size_t size, const char *name)
+{
+  engine->finish();
+  free(owned);
+  owned = NULL;
+  text = t;
+  indexed = false;
+  line = 1;
+  filename = name;
+  *engine->flex_debug = yy_flex_debug;
+  engine->start(NULL, text, size);
+}
+
+int cool_scanner::text_line()
+{
+  line = lines.line(*engine->yytext + *engine->yyleng - text, line);
+  return line;
+}
+
+int cool_scanner::column() const
+{
+  return indexed ? lines.column(token_start()) : 0;
+}
+
+int cool_scanner::scan(scanned_token *tokens, int max)
+{
+  int (*lex)() = engine->lex;
+  int n;
+
+  for (n = 0; n < max; n++) {
+    scanned_token& t = tokens[n];
+    if ((t.token = lex()) == 0)
+      break;
+    t.lineno = lineno();
+    t.filename = filename;
+    t.value = *engine->cool_yylval;
+  }
+  return n;
+}
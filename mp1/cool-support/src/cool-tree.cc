@@ -7,10 +7,14 @@
 //////////////////////////////////////////////////////////
 
 
+#include <map>
+#include <mutex>
 #include "tree.h"
 #include "cool-tree.handcode.h"
 #include "cool-tree.h"
 
+extern int hashcons_leaves;     // set by -H; see handle_flags.cc
+
 
 // constructors' functions
 Program program_class::copy_Program()
@@ -624,18 +628,62 @@ Expression comp(Expression e1)
   return new comp_class(e1);
 }
 
+//
+// Hash-consed leaves.  int_const, string_const, bool_const and no_expr
+// are pure functions of an interned Symbol (or a Boolean), so when
+// hashcons_leaves is set the constructors below hand out one shared node
+// per distinct value instead of allocating a fresh one.  Two such leaves
+// are then structurally equal exactly when they are the same pointer.
+//
+// A shared node keeps the line number of its first occurrence.  object
+// is deliberately not shared: its type depends on the scope it appears
+// in, and set_type() on a shared node would leak that type everywhere.
+//
+// When files are parsed on several threads (frontend -j), which share
+// the string tables, the shared leaves are looked up under a lock too.
+//
+static std::map<Symbol, Expression> int_const_nodes;
+static std::map<Symbol, Expression> string_const_nodes;
+static Expression bool_const_nodes[2];
+static Expression no_expr_node;
+static std::mutex shared_leaves_mutex;
+
+class shared_leaves_lock {
+public:
+  shared_leaves_lock()  { if (string_tables_shared) shared_leaves_mutex.lock(); }
+  ~shared_leaves_lock() { if (string_tables_shared) shared_leaves_mutex.unlock(); }
+};
+
 Expression int_const(Symbol token)
 {
+  if (hashcons_leaves) {
+    shared_leaves_lock hold;
+    Expression &e = int_const_nodes[token];
+    if (!e) e = new int_const_class(token);
+    return e;
+  }
   return new int_const_class(token);
 }
 
 Expression bool_const(Boolean val)
 {
+  if (hashcons_leaves) {
+    shared_leaves_lock hold;
+    Expression &e = bool_const_nodes[val != 0];
+    if (!e) e = new bool_const_class(val);
+    return e;
+  }
   return new bool_const_class(val);
 }
 
 Expression string_const(Symbol token)
 {
+  if (hashcons_leaves) {
+    shared_leaves_lock hold;
+    Expression &e = string_const_nodes[token];
+    if (!e) e = new string_const_class(token);
+    return e;
+  }
   return new string_const_class(token);
 }
 
@@ -651,6 +699,11 @@ Expression isvoid(Expression e1)
 
 Expression no_expr()
 {
+  if (hashcons_leaves) {
+    shared_leaves_lock hold;
+    if (!no_expr_node) no_expr_node = new no_expr_class();
+    return no_expr_node;
+  }
   return new no_expr_class();
 }
 
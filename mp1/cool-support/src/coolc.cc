@@ -0,0 +1,209 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  coolc.cc
+//
+//  The whole compiler in one process.  Where the course pipeline is
+//
+//      lexer files | parser | semant | cgen
+//
+//  with the tokens and the AST printed and read back at each pipe, coolc
+//  scans and parses the files in process (as frontend does) and runs
+//  semant and cgen on the Program it has in memory.
+//
+//      --stop-after=lex      print the tokens, as lexer does
+//      --stop-after=parse    print the AST, as parser does
+//      --stop-after=semant   print the typed AST, as semant does
+//
+//  Otherwise the code is written to the -o file, or to the first file
+//  name with its extension replaced by .s, as cgen does.  All the other
+//  flags are those of handle_flags.
+//
+//  The semantic analyser and code generator are later assignments; the
+//  stages that call them are compiled in when the build defines
+//  COOLC_SEMANT and COOLC_CGEN.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>    // for getopt
+#include "cool-io.h"
+#include "cool-tree.h"
+#include "utilities.h"
+#include "cool-parse.h"
+#include "ast-census.h"
+#include "ast-binary.h"
+#include "token-stream.h"
+#include "source-scan.h"
+#include "phase-timer.h"
+
+extern parser_local Program ast_root;    // the AST produced by the parse
+
+parser_local int curr_lineno;   // 0 until a token is read, as in parser
+parser_local const char *curr_filename = "<stdin>";
+
+extern parser_local int omerrs; // a count of lex and parse errors
+extern int dump_census;        // -C: print AST statistics on cerr
+extern int binary_ast;         // -b: write the AST in binary
+extern int binary_tokens;      // -B: write the tokens in binary
+extern int threaded_lexer;     // -L: run the scanner on its own thread
+extern char *out_filename;     // -o: file name for generated code
+
+extern int optind;             // used for option processing
+void handle_flags(int argc, char *argv[]);
+extern void dump_cool_token(ostream& out, int lineno,
+			    int token, YYSTYPE yylval);
+
+enum stage { STAGE_LEX, STAGE_PARSE, STAGE_SEMANT, STAGE_CGEN };
+
+static const char *stage_names[] = { "lex", "parse", "semant", "cgen" };
+
+//
+// Take --stop-after=stage out of argv, so that handle_flags sees only
+// the flags it knows.
+//
+static stage stop_after(int& argc, char *argv[])
+{
+  const char *opt = "--stop-after=";
+  stage last = STAGE_CGEN;
+  int j = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], opt, strlen(opt)) != 0) {
+      argv[j++] = argv[i];
+      continue;
+    }
+    const char *name = argv[i] + strlen(opt);
+    int s;
+    for (s = STAGE_LEX; s <= STAGE_CGEN; s++)
+      if (strcmp(name, stage_names[s]) == 0)
+	break;
+    if (s > STAGE_CGEN) {
+      cerr << argv[0] << ": unknown stage " << name
+	   << " (lex, parse, semant or cgen)\n";
+      exit(1);
+    }
+    last = (stage) s;
+  }
+  argc = j;
+  argv[argc] = NULL;
+  return last;
+}
+
+static void print_name(TokenWriter *binary, const char *name)
+{
+  if (binary)
+    binary->name(name);
+  else
+    cout << "#name \"" << name << "\"\n";
+}
+
+//
+// Print the token stream in the form lextest does, with a #name line
+// for each file, even one with no tokens.  A token's curr_filename is
+// the name in "files", so a file that is not the one the last token
+// came from was opened since.
+//
+static void print_tokens(char **files, int nfiles)
+{
+  TokenWriter *binary = binary_tokens ? new TokenWriter(cout) : NULL;
+  const char *name = NULL;
+  int named = 0;                 // files whose #name has been printed
+  int token;
+
+  while ((token = scan_token()) != 0) {
+    if (curr_filename != name) {
+      name = curr_filename;
+      while (named < nfiles && files[named] != name)
+	print_name(binary, files[named++]);
+      named++;
+      print_name(binary, name);
+    }
+    if (binary)
+      binary->token(curr_lineno, token, cool_yylval);
+    else
+      dump_cool_token(cout, curr_lineno, token, cool_yylval);
+  }
+  while (named < nfiles)
+    print_name(binary, files[named++]);
+}
+
+static void print_ast()
+{
+  phase_scope timing(dump_phase);
+  if (binary_ast)
+    dump_binary_ast(cout, ast_root);
+  else
+    ast_root->dump_with_types(cout,0);
+}
+
+int main(int argc, char *argv[]) {
+    stage last = stop_after(argc, argv);
+    handle_flags(argc, argv);
+    buffer_cout();
+
+    char **files = argv + optind;
+    int nfiles = argc - optind;
+    scan_files(files, nfiles);
+    if (last == STAGE_LEX) {
+	print_tokens(files, nfiles);
+	return 0;
+    }
+
+    parse_files(threaded_lexer);
+    if (omerrs != 0) {
+	cerr << "Compilation halted due to lex and parse errors\n";
+	exit(1);
+    }
+    if (dump_census)
+	ast_census(ast_root, cerr);
+    if (last == STAGE_PARSE) {
+	print_ast();
+	return 0;
+    }
+
+#ifdef COOLC_SEMANT
+    {
+	phase_scope timing(semant_phase);
+	ast_root->semant();
+    }
+    if (last == STAGE_SEMANT) {
+	print_ast();
+	return 0;
+    }
+#else
+    cerr << argv[0] << ": semant is not built into this coolc\n";
+    exit(1);
+#endif
+
+#ifdef COOLC_CGEN
+    if (!out_filename && nfiles > 0) {   // no -o option
+	char *dot = strrchr(files[0], '.');
+	if (dot) *dot = '\0'; // strip off file extension
+	out_filename = new char[strlen(files[0])+8];
+	strcpy(out_filename, files[0]);
+	strcat(out_filename, ".s");
+    }
+    phase_scope timing(cgen_phase);
+    if (out_filename) {
+	ofstream s(out_filename);
+	if (!s) {
+	    cerr << "Cannot open output file " << out_filename << endl;
+	    exit(1);
+	}
+	ast_root->cgen(s);
+    } else {
+	ast_root->cgen(cout);
+    }
+#else
+    cerr << argv[0] << ": cgen is not built into this coolc\n";
+    exit(1);
+#endif
+    return 0;
+}
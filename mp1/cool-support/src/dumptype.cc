@@ -4,11 +4,21 @@
 //
 #include "copyright.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include "cool.h"
 #include "tree.h"
 #include "cool-tree.h"
 #include "utilities.h"
 
+// defined in handle_flags.cc; number of threads for dumping classes (-j)
+extern int dump_threads;
+
 // defined in stringtab.cc
 void dump_Symbol(ostream& stream, int padding, Symbol b); 
 
@@ -113,9 +123,9 @@ void dump_Boolean(ostream& stream, int padding, Boolean b);
 void Expression_class::dump_type(ostream& stream, int n)
 {
   if (type)
-    { stream << pad(n) << ": " << type << endl; }
+    { stream << pad(n) << ": " << type << '\n'; }
   else
-    { stream << pad(n) << ": _no_type" << endl; }
+    { stream << pad(n) << ": _no_type\n"; }
 }
 
 void dump_line(ostream& stream, int n, tree_node *t)
@@ -134,14 +144,75 @@ void dump_line(ostream& stream, int n, tree_node *t)
 //  classes.  The methods first, more, next, and nth on AST lists
 //  are defined in tree.h.
 //
+//
+//  With -j N (N > 1) the classes are rendered by a pool of N threads
+//  instead; see dump_classes_parallel below.  The output is the same.
+//
+static void dump_classes_parallel(ostream& stream, int n, Classes classes);
+
 void program_class::dump_with_types(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_program\n";
+   if (dump_threads > 1) {
+     dump_classes_parallel(stream, n+2, classes);
+     return;
+   }
    for(int i = classes->first(); classes->more(i); i = classes->next(i))
      classes->nth(i)->dump_with_types(stream, n+2);
 }
 
+//
+//  dump_classes_parallel renders each class subtree into its own buffer.
+//  Worker threads take the next unclaimed class; the calling thread
+//  writes the buffers to "stream" strictly in class order as soon as
+//  each one is finished, and frees it, so output is byte-identical to
+//  the sequential loop and at most the classes that finished early are
+//  held in memory.  dump_with_types only reads the tree, so the workers
+//  need no locking beyond handing over the finished buffers.
+//
+static void dump_classes_parallel(ostream& stream, int n, Classes classes)
+{
+   std::vector<Class_> todo;
+   for(int i = classes->first(); classes->more(i); i = classes->next(i))
+     todo.push_back(classes->nth(i));
+
+   int count = todo.size();
+   std::vector<std::string> buffers(count);
+   std::vector<bool> done(count, false);
+   std::atomic<int> next(0);
+   std::mutex lock;
+   std::condition_variable finished;
+
+   std::vector<std::thread> workers;
+   int nworkers = dump_threads < count ? dump_threads : count;
+   for (int w = 0; w < nworkers; w++)
+     workers.push_back(std::thread([&]() {
+       int i;
+       while ((i = next++) < count) {
+	 std::ostringstream buf;
+	 todo[i]->dump_with_types(buf, n);
+	 std::lock_guard<std::mutex> guard(lock);
+	 buffers[i] = buf.str();
+	 done[i] = true;
+	 finished.notify_one();
+       }
+     }));
+
+   for (int i = 0; i < count; i++) {
+     std::string out;
+     {
+       std::unique_lock<std::mutex> guard(lock);
+       finished.wait(guard, [&]() { return (bool) done[i]; });
+       out.swap(buffers[i]);
+     }
+     stream.write(out.data(), out.size());
+   }
+
+   for (int w = 0; w < nworkers; w++)
+     workers[w].join();
+}
+
 //
 // Prints the components of a class, including all of the features.
 // Note that printing the Features is another use of an iterator.
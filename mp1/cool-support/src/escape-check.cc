@@ -0,0 +1,137 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  escape-check.cc
+//
+//  make check-escape: strings of random bytes are dumped as STR_CONST
+//  tokens by dump_cool_token, which escapes them with
+//  print_escaped_string, and read back by the token lexer of
+//  tokens-lex.cc, as the parser reads them.  Each must come back as the
+//  bytes it was.  The lengths are those on either side of each multiple
+//  of 16, where print_escaped_string goes from checking sixteen bytes at
+//  a time to checking one; one more string holds every byte value.  A
+//  string constant cannot hold a NUL, so the bytes are 1 to 255.
+//
+//  escape-check [-n strings-per-length] [-s seed]
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>     // for getopt
+#include <sstream>
+#include <string>
+#include <vector>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "utilities.h"
+
+//
+//  What the token lexer reads from and sets, which the parser defines
+//  when it is linked in.
+//
+FILE *token_file;
+int curr_lineno;
+const char *curr_filename = "<stdin>";
+YYSTYPE cool_yylval;
+int cool_yydebug;                // to link with handle_flags
+
+extern int cool_yylex();         // the token lexer of tokens-lex.cc
+extern int yy_flex_debug;        // which flex -d leaves on
+extern void dump_cool_token(ostream& out, int lineno,
+			    int token, YYSTYPE yylval);
+
+static const int max_length = 16 * 16 + 1;
+
+static std::string random_bytes(int len)
+{
+  std::string s(len, ' ');
+  for (int i = 0; i < len; i++)
+    s[i] = 1 + rand() % 255;
+  return s;
+}
+
+int main(int argc, char *argv[])
+{
+  int per_length = 20;
+  unsigned seed = 1;
+  int c;
+
+  while ((c = getopt(argc, argv, "n:s:")) != -1) {
+    switch (c) {
+    case 'n':
+      per_length = atoi(optarg);
+      break;
+    case 's':
+      seed = atoi(optarg);
+      break;
+    default:
+      cerr << "usage: " << argv[0] << " [-n strings-per-length] [-s seed]\n";
+      exit(1);
+    }
+  }
+  srand(seed);
+  yy_flex_debug = 0;
+
+  std::vector<std::string> strings;
+  std::string every_byte;
+  for (int b = 1; b < 256; b++)
+    every_byte += (char) b;
+  strings.push_back(every_byte);
+  for (int len = 0; len <= max_length; len++)
+    if (len % 16 <= 1 || len % 16 == 15)
+      for (int i = 0; i < per_length; i++)
+	strings.push_back(random_bytes(len));
+
+  std::ostringstream dump;
+  for (size_t i = 0; i < strings.size(); i++) {
+    cool_yylval.symbol = stringtable.add_string(strings[i].c_str());
+    dump_cool_token(dump, i + 1, STR_CONST, cool_yylval);
+  }
+
+  token_file = tmpfile();
+  if (token_file == NULL) {
+    cerr << "escape-check: could not make a temporary file\n";
+    exit(1);
+  }
+  fwrite(dump.str().data(), 1, dump.str().size(), token_file);
+  rewind(token_file);
+
+  int failures = 0;
+  for (size_t i = 0; i < strings.size(); i++) {
+    int token = cool_yylex();
+    if (token != STR_CONST || curr_lineno != (int) i + 1) {
+      cerr << "string " << i + 1 << " came back as the token "
+	   << cool_token_to_string(token) << " of line " << curr_lineno << "\n";
+      failures++;
+      break;
+    }
+    Symbol sym = cool_yylval.symbol;
+    if (sym->get_len() != (int) strings[i].size() ||
+	memcmp(sym->get_string(), strings[i].data(), strings[i].size())) {
+      cerr << "string " << i + 1 << " of length " << strings[i].size()
+	   << " came back with length " << sym->get_len() << " as\n";
+      dump_cool_token(cerr, i + 1, STR_CONST, cool_yylval);
+      cerr << "\n";
+      if (++failures == 10)
+	break;
+    }
+  }
+  if (failures == 0 && cool_yylex() != 0) {
+    cerr << "escape-check: the token lexer read more tokens than were dumped\n";
+    failures++;
+  }
+  if (failures) {
+    cerr << "escape-check: strings did not come back as they were\n";
+    exit(1);
+  }
+  cerr << "escape-check: " << strings.size()
+       << " strings came back as they were\n";
+  return 0;
+}
@@ -0,0 +1,75 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  frontend-phase.cc
+//
+//  Lexes and parses COOL source files in one process.  The parser takes
+//  its tokens straight from the flex scanner in cool-lex.cc rather than
+//  from the text that "lexer" prints and tokens-lex reads back, so no
+//  token is printed, re-scanned or interned twice.  The output is the
+//  same AST that "lexer files | parser" prints; that pipeline is still
+//  built for debugging either half.
+//
+//  With -L the scanner runs on a thread of its own, so lexing and
+//  parsing overlap (see source-scan.cc).  With -j N and several files,
+//  the files are parsed separately on N threads and their classes put
+//  together in order (see parallel-parse.cc).
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <unistd.h>    // for getopt
+#include "cool-io.h"
+#include "cool-tree.h"
+#include "utilities.h"
+#include "cool-parse.h"
+#include "ast-census.h"
+#include "ast-binary.h"
+#include "source-scan.h"
+#include "parallel-parse.h"
+#include "phase-timer.h"
+
+//
+// These globals keep everything working.
+//
+extern parser_local Program ast_root;    // the AST produced by the parse
+
+parser_local int curr_lineno;   // 0 until a token is read, as in parser
+parser_local const char *curr_filename = "<stdin>";
+
+extern parser_local int omerrs; // a count of lex and parse errors
+extern int dump_census;        // -C: print AST statistics on cerr
+extern int binary_ast;         // -b: write the AST in binary
+extern int threaded_lexer;     // -L: run the scanner on its own thread
+extern int dump_threads;       // -j: threads for parsing and dumping
+
+extern int optind;             // used for option processing
+void handle_flags(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+    handle_flags(argc, argv);
+    buffer_cout();
+    if (dump_threads > 1 && argc - optind > 1) {
+	parse_files_parallel(argv + optind, argc - optind, dump_threads);
+    } else {
+	scan_files(argv + optind, argc - optind);
+	parse_files(threaded_lexer);
+    }
+    if (omerrs != 0) {
+	cerr << "Compilation halted due to lex and parse errors\n";
+	exit(1);
+    }
+    if (dump_census)
+	ast_census(ast_root, cerr);
+    phase_scope timing(dump_phase);
+    if (binary_ast)
+	dump_binary_ast(cout, ast_root);
+    else
+	ast_root->dump_with_types(cout,0);
+    return 0;
+}
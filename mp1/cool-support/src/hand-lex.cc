@@ -0,0 +1,295 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  hand-lex.cc
+//
+//  A COOL scanner written by hand, to build in place of the flex
+//  scanner of cool-lex.cc (make SCANNER=hand).  flex's scanner takes
+//  every byte through its tables, yy_ec to a class, yy_accept and
+//  yy_nxt to the next state; this one looks at the first byte of a
+//  token and goes straight to the code for that kind of token, in a
+//  switch the compiler makes a jump table of.  Identifiers run through
+//  one table of the bytes that can continue them, keywords are looked
+//  up afterwards (cool-keywords.h), and string constants, white space
+//  and comments go to string-const.h and skip-blanks.h.
+//
+//  The tokens, their values, their line numbers and the errors are
+//  those of the reference lexer; make check-scanner compares the two
+//  on the examples, the benchmark corpus and bench/lex-cases.
+//
+//  It keeps the contract of cool-lex.cc: cool_yylex returns the next
+//  token with its value in cool_yylval and its line in curr_lineno, and
+//  reads from fin.  The parts of flex's interface that the rest of
+//  the compiler uses are here too: yy_scan_buffer, yy_delete_buffer
+//  and yyrestart (scan-input.h, scanner-engine.cc), yytext and yyleng,
+//  and yy_flex_debug (-l).  Unlike flex it never writes to the text, so
+//  yytext is not NUL-terminated; it is yyleng bytes long.
+//
+//  It needs all of its input in memory.  A regular file is given to
+//  it whole by yy_scan_buffer; anything else is read to its end by
+//  yyrestart before the first token is scanned.  So no newlines are
+//  counted while scanning: the lines of the text are indexed once
+//  (line-index.h), and curr_lineno is looked up from where each token
+//  ends, a step forward from the line of the token before it.
+//
+//  scanner-engine.cc includes this file, as it does cool-lex.cc, so it
+//  keeps all of its state in globals and statics of its own.  There,
+//  with SCANNER_ENGINE defined, curr_lineno is not kept at all: the
+//  cool_scanner that owns the engine indexes the text itself and finds
+//  the lines of tokens from their offsets.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "utilities.h"
+#include "cool-keywords.h"
+#include "string-const.h"
+#include "skip-blanks.h"
+#include "scan-input.h"
+#include "line-index.h"
+
+extern FILE *fin;                 // read from when there is no buffer
+extern int curr_lineno;
+extern YYSTYPE cool_yylval;
+
+char *yytext;                     // the last token; yyleng bytes, no NUL
+int yyleng;
+int yy_flex_debug;                // -l: print each token on stderr
+
+//
+// The text being scanned.  Two NULs follow "end", as yy_scan_buffer
+// requires, so a token may look one byte ahead without a bounds check.
+//
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+
+struct yy_buffer_state {
+  char *base;                     // the start of the text
+  char *pos;                      // where the next token starts
+  char *end;
+#ifndef SCANNER_ENGINE
+  line_index lines;               // of the text
+  int line;                       // of the last token
+#endif
+};
+
+static YY_BUFFER_STATE current;
+static yy_buffer_state stream_buffer;   // what yyrestart read
+static char *stream_text;
+
+static void set_text(YY_BUFFER_STATE b, char *base, size_t size)
+{
+  b->base = b->pos = base;
+  b->end = base + size;
+#ifndef SCANNER_ENGINE
+  b->lines.build(base, size);
+  b->line = 1;
+#endif
+  current = b;
+}
+
+YY_BUFFER_STATE yy_scan_buffer(char *base, size_t size)
+{
+  if (size < 2 || base[size - 2] || base[size - 1])
+    return NULL;
+  YY_BUFFER_STATE b = new yy_buffer_state;
+  set_text(b, base, size - 2);
+  return b;
+}
+
+void yy_delete_buffer(YY_BUFFER_STATE b)
+{
+  if (b == current)
+    current = NULL;
+  if (b != &stream_buffer)
+    delete b;
+}
+
+//
+// Scan "f" from where it is: all of it is read, with two NULs after it.
+//
+void yyrestart(FILE *f)
+{
+  size_t size;
+
+  free(stream_text);
+  stream_text = read_all_text(f, size);
+  if (stream_text == NULL) {
+    fprintf(stderr, "out of memory reading the input of the scanner\n");
+    exit(1);
+  }
+  set_text(&stream_buffer, stream_text, size);
+}
+
+//////////////////////////////////////////////////////////////////
+//
+//  Byte classes
+//
+//////////////////////////////////////////////////////////////////
+
+struct hand_lex_tables {
+  bool id_char[256];              // [a-zA-Z0-9_]
+  bool digit[256];
+
+  constexpr hand_lex_tables() : id_char(), digit()
+  {
+    for (int c = '0'; c <= '9'; c++)
+      id_char[c] = digit[c] = true;
+    for (int c = 'a'; c <= 'z'; c++)
+      id_char[c] = id_char[c - 'a' + 'A'] = true;
+    id_char['_'] = true;
+  }
+};
+
+static constexpr hand_lex_tables tables;
+
+//
+// The text of each single-byte error: a byte that begins no token is
+// reported as itself, and a NUL as "", which dump_cool_token prints as
+// "\000".
+//
+static char error_chars[256][2];
+
+//////////////////////////////////////////////////////////////////
+//
+//  cool_yylex
+//
+//  One pass of the loop for each run of white space or comment, which
+//  is skipped, and one for the token, which is returned.  The case for
+//  each first byte is written so that the usual token falls straight
+//  through: a letter is an identifier, and only ( - * < = look at the
+//  byte after them.
+//
+//////////////////////////////////////////////////////////////////
+
+static int token(char *start, char *p, int t)
+{
+  current->pos = p;
+  yytext = start;
+  yyleng = p - start;
+#ifndef SCANNER_ENGINE
+  curr_lineno = current->line =
+    current->lines.line(p - current->base, current->line);
+#endif
+  if (yy_flex_debug)
+    fprintf(stderr, "--token %d at byte %ld (\"%.*s\")\n", t,
+	    (long) (start - current->base), yyleng, yytext);
+  return t;
+}
+
+static int error(char *start, char *p, const char *msg)
+{
+  cool_yylval.error_msg = msg;
+  return token(start, p, ERROR);
+}
+
+int cool_yylex()
+{
+  if (!current)
+    yyrestart(fin);
+
+  char *p = current->pos;
+  char *end = current->end;
+
+  for (;;) {
+    if (p >= end) {
+      yytext = end;
+      yyleng = 0;
+      current->pos = end;
+      return 0;
+    }
+
+    char *start = p;
+    unsigned char c = *p++;
+
+    switch (c) {
+    case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g':
+    case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n':
+    case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+    case 'v': case 'w': case 'x': case 'y': case 'z':
+    case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G':
+    case 'H': case 'I': case 'J': case 'K': case 'L': case 'M': case 'N':
+    case 'O': case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U':
+    case 'V': case 'W': case 'X': case 'Y': case 'Z': {
+      while (tables.id_char[(unsigned char) *p])
+	p++;
+      int len = p - start;
+      int t = cool_keyword(start, len);
+      if (t == BOOL_CONST)
+	cool_yylval.boolean = (c == 't');
+      else if (t == 0) {
+	t = (c <= 'Z') ? TYPEID : OBJECTID;
+	cool_yylval.symbol = idtable.add_string(start, len);
+      }
+      return token(start, p, t);
+    }
+
+    case ' ': case '\t': case '\n': case '\r': case '\f': case '\v':
+      p = (char *) skip_white_space(start, end);
+      continue;
+
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+      while (tables.digit[(unsigned char) *p])
+	p++;
+      cool_yylval.symbol = inttable.add_string(start, p - start);
+      return token(start, p, INT_CONST);
+
+    case '"': {
+      string_const s;
+      p = (char *) scan_string_const(p, end, s);
+      cool_yylval = s.value;
+      return token(start, p, s.token);
+    }
+
+    case '-':
+      if (*p != '-')
+	return token(start, p, '-');
+      p = (char *) skip_line_comment(p + 1, end);
+      continue;
+
+    case '(': {
+      if (*p != '*')
+	return token(start, p, '(');
+      int depth = 1;
+      p = (char *) skip_block_comment(p + 1, end, depth);
+      if (depth > 0)
+	return error(start, p, "EOF in comment");
+      continue;
+    }
+
+    case '*':
+      if (*p != ')')
+	return token(start, p, '*');
+      return error(start, p + 1, "Unmatched *)");
+
+    case '<':
+      if (*p == '-')
+	return token(start, p + 1, ASSIGN);
+      if (*p == '=')
+	return token(start, p + 1, LE);
+      return token(start, p, '<');
+
+    case '=':
+      if (*p == '>')
+	return token(start, p + 1, DARROW);
+      return token(start, p, '=');
+
+    case '+': case '/': case '~': case '.': case ',': case ';': case ':':
+    case ')': case '@': case '{': case '}':
+      return token(start, p, c);
+
+    default:
+      error_chars[c][0] = c;
+      return error(start, p, error_chars[c]);
+    }
+  }
+}
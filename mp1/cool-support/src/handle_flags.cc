@@ -9,6 +9,7 @@
 #include "cool-io.h"
 #include <unistd.h>
 #include "cgen_gc.h"
+#include "phase-timer.h"
 
 //
 // coolc provides a debugging switch for each phase of the compiler,
@@ -30,6 +31,15 @@ extern int cool_yydebug;        // for the parser
        bool disable_reg_alloc;  // Don't do register allocation
 
        int cgen_optimize;       // optimize switch for code generator 
+       int hashcons_leaves;     // share constant and no_expr AST leaves
+       int dump_census;         // print AST node/list statistics
+       int dump_threads;        // threads for dump_with_types of classes,
+                                // and for parsing files (frontend)
+       int binary_ast;          // write the AST in binary, not as text
+       int compact_dump;        // dump the AST without indentation
+       int binary_tokens;       // write the token stream in binary
+       int threaded_lexer;      // scan on a thread of its own (frontend)
+       int time_phases;         // report time and memory of each phase
        char *out_filename;      // file name for generated code
        Memmgr cgen_Memmgr = GC_NOGC;      // enable/disable garbage collection
        Memmgr_Test cgen_Memmgr_Test = GC_NORMAL;  // normal/test GC
@@ -42,6 +52,8 @@ extern char *optarg;
 void handle_flags(int argc, char *argv[]) {
   int c;
   int unknownopt = 0;
+  int timing = 0;
+  char *timing_file = NULL;
 
   // no debugging or optimization by default
   yy_flex_debug = 0;
@@ -51,9 +63,17 @@ void handle_flags(int argc, char *argv[]) {
   cgen_debug = 0;
   cgen_optimize = 0;
   disable_reg_alloc = 0;
+  hashcons_leaves = 0;
+  dump_census = 0;
+  dump_threads = 1;
+  binary_ast = 0;
+  compact_dump = 0;
+  binary_tokens = 0;
+  threaded_lexer = 0;
+  time_phases = 0;
   
 
-  while ((c = getopt(argc, argv, "lpscvrOo:gtT")) != -1) {
+  while ((c = getopt(argc, argv, "lpscvrOo:gtTHCj:bkBLPJ:")) != -1) {
     switch (c) {
 #ifdef DEBUG
     case 'l':
@@ -99,6 +119,34 @@ void handle_flags(int argc, char *argv[]) {
     case 'O':  // enable optimization
       cgen_optimize = 1;
       break;
+    case 'H':  // hash-cons constant and no_expr leaves of the AST
+      hashcons_leaves = 1;
+      break;
+    case 'C':  // report AST node counts, sizes, depths and list shapes
+      dump_census = 1;
+      break;
+    case 'j':  // dump the classes of the AST (and parse files) on this many threads
+      dump_threads = atoi(optarg);
+      break;
+    case 'b':  // hand the AST to the next phase in the binary format
+      binary_ast = 1;
+      break;
+    case 'k':  // leave out the indentation of the text AST
+      compact_dump = 1;
+      break;
+    case 'B':  // hand the tokens to the parser in the binary format
+      binary_tokens = 1;
+      break;
+    case 'L':  // overlap scanning and parsing on two threads
+      threaded_lexer = 1;
+      break;
+    case 'P':  // print the time and memory of each phase on cerr
+      timing = 1;
+      break;
+    case 'J':  // write them to a file as JSON instead
+      timing = 1;
+      timing_file = optarg;
+      break;
     case '?':
       unknownopt = 1;
       break;
@@ -111,11 +159,14 @@ void handle_flags(int argc, char *argv[]) {
   if (unknownopt) {
       cerr << "usage: " << argv[0] << 
 #ifdef DEBUG
-	  " [-lvpscOgtr -o outname] [input-files]\n";
+	  " [-lvpscOgtrHCbkBLP -j threads -o outname -J timing.json] [input-files]\n";
 #else
-      " [-Ogt -o outname] [input-files]\n";
+      " [-OgtHCbkBLP -j threads -o outname -J timing.json] [input-files]\n";
 #endif
       exit(1);
   }
 
+  if (timing)
+    time_phases_until_exit(argv[0], timing_file);
+
 }
@@ -0,0 +1,245 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  incremental-check.cc
+//
+//  make check-incremental: random edits are made to each file, one
+//  after another, with incremental_lexer::edit, and after each one the
+//  tokens it gives are compared with those of scanning the edited text
+//  from the start: the same tokens with the same values, at the same
+//  offsets, lines and columns.
+//
+//  An edit replaces a span of the text with a fragment of COOL that
+//  may open or close a string or a comment.  It is made at a random
+//  place, at the start or end of a token, inside a string constant, or
+//  just inside a comment, and may delete up to a few tokens' worth.
+//
+//  incremental-check [-n edits-per-file] [-s seed] files
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>     // for getopt
+#include <string>
+#include <vector>
+#include "cool-io.h"
+#include "cool-parse.h"
+#include "cool-tokens.h"
+#include "utilities.h"
+#include "incremental-lex.h"
+
+//
+// The globals of the parser and of source-scan.cc, which the scanners
+// and handle_flags refer to.
+//
+parser_local YYSTYPE cool_yylval;
+parser_local int curr_lineno;
+parser_local const char *curr_filename = "<stdin>";
+int cool_yydebug;
+FILE *fin;
+int scan_lineno;
+YYSTYPE scan_yylval;
+
+static const char *fragments[] = {
+  "", " ", "\n", "x", "X1", "42", "class", "true", "<-", "<", "-", "=",
+  "(", ")", "*", "\"", "\\", "\\\"", "\"a\\\"b\"", "\"\\\n\"", "(*", "*)",
+  "--", "--\n", "(* (* *) *)", "*)(*", "\" (* \"", "(* \" *)", "\n--x\n"
+};
+static const int nfragments = sizeof(fragments) / sizeof(fragments[0]);
+
+static int pick(int n)
+{
+  return n > 0 ? rand() % n : 0;
+}
+
+//
+// Where the next edit starts.
+//
+static size_t edit_start(const std::string& text,
+			 const std::vector<lexed_token>& toks)
+{
+  size_t size = text.size();
+  switch (pick(4)) {
+  case 0:                                  // at the start or end of a token
+    if (!toks.empty()) {
+      const lexed_token& t = toks[pick(toks.size())];
+      return pick(2) ? t.start : t.end;
+    }
+    break;
+  case 1: {                                // inside a string constant
+    std::vector<size_t> strings;
+    for (size_t i = 0; i < toks.size(); i++)
+      if (toks[i].token == STR_CONST && toks[i].end - toks[i].start > 2)
+	strings.push_back(i);
+    if (!strings.empty()) {
+      const lexed_token& t = toks[strings[pick(strings.size())]];
+      return t.start + 1 + pick(t.end - t.start - 1);
+    }
+    break;
+  }
+  case 2: {                                // just inside a comment
+    size_t c = text.find("(*", pick(size + 1));
+    if (c == std::string::npos)
+      c = text.find("(*");
+    if (c != std::string::npos)
+      return std::min(size, c + 2 + pick(8));
+    break;
+  }
+  }
+  return pick(size + 1);
+}
+
+//
+// Where it ends: where it starts, a few bytes on, or at the end of a
+// token up to three after it.
+//
+static size_t edit_end(size_t start, const std::string& text,
+		       const std::vector<lexed_token>& toks)
+{
+  size_t size = text.size();
+  switch (pick(3)) {
+  case 0:
+    return start;
+  case 1:
+    return std::min(size, start + pick(16));
+  }
+  size_t i = 0;
+  while (i < toks.size() && toks[i].end <= start)
+    i++;
+  i += pick(3);
+  return i < toks.size() ? toks[i].end : size;
+}
+
+static bool same_value(const lexed_token& a, const lexed_token& b)
+{
+  const cool_token_info *t = cool_tokens.lookup(a.token);
+  switch (t ? t->value : TOKVAL_NONE) {
+  case TOKVAL_ID:
+  case TOKVAL_INT:
+  case TOKVAL_STR:
+    return a.value.symbol == b.value.symbol;
+  case TOKVAL_BOOL:
+    return a.value.boolean == b.value.boolean;
+  case TOKVAL_ERROR:
+    return !strcmp(a.value.error_msg, b.value.error_msg);
+  default:
+    return true;
+  }
+}
+
+//
+// The index of the first token in which "lexer" and "full" differ, or
+// -1 if they have the same tokens.
+//
+static int first_difference(const incremental_lexer& lexer,
+			    const incremental_lexer& full)
+{
+  const std::vector<lexed_token>& got = lexer.tokens();
+  const std::vector<lexed_token>& want = full.tokens();
+  size_t i;
+
+  for (i = 0; i < got.size() && i < want.size(); i++)
+    if (got[i].token != want[i].token ||
+	got[i].start != want[i].start || got[i].end != want[i].end ||
+	!same_value(got[i], want[i]) ||
+	lexer.line(got[i]) != full.line(want[i]) ||
+	lexer.column(got[i]) != full.column(want[i]))
+      return i;
+  return got.size() == want.size() ? -1 : (int) i;
+}
+
+static void print_token(const incremental_lexer& lexer, int i)
+{
+  if (i >= (int) lexer.tokens().size()) {
+    cerr << "  (none)\n";
+    return;
+  }
+  const lexed_token& t = lexer.tokens()[i];
+  cerr << "  " << cool_token_to_string(t.token) << " at "
+       << t.start << "-" << t.end << ", line " << lexer.line(t)
+       << " column " << lexer.column(t) << "\n";
+}
+
+//
+// Make "edits" edits to "name"; false if one went wrong.
+//
+static bool check_file(const char *name, int edits)
+{
+  FILE *f = fopen(name, "r");
+  if (f == NULL) {
+    cerr << "Could not open input file " << name << "\n";
+    exit(1);
+  }
+  std::string text;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    text.append(buf, n);
+  fclose(f);
+
+  incremental_lexer lexer(text.data(), text.size(), name);
+  for (int e = 0; e < edits; e++) {
+    size_t start = edit_start(text, lexer.tokens());
+    size_t end = edit_end(start, text, lexer.tokens());
+    const char *fragment = fragments[pick(nfragments)];
+
+    text.replace(start, end - start, fragment);
+    lexer.edit(start, end, fragment, strlen(fragment));
+    incremental_lexer full(text.data(), text.size(), name);
+
+    int i = first_difference(lexer, full);
+    if (i >= 0) {
+      cerr << name << ": edit " << e + 1 << ", of " << start << "-" << end
+	   << " to \"";
+      print_escaped_string(cerr, fragment);
+      cerr << "\", gives token " << i << "\n";
+      print_token(lexer, i);
+      cerr << "where scanning it all gives\n";
+      print_token(full, i);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  int edits = 200;
+  unsigned seed = 1;
+  int c;
+
+  while ((c = getopt(argc, argv, "n:s:")) != -1) {
+    switch (c) {
+    case 'n':
+      edits = atoi(optarg);
+      break;
+    case 's':
+      seed = atoi(optarg);
+      break;
+    default:
+      cerr << "usage: " << argv[0] << " [-n edits-per-file] [-s seed] files\n";
+      exit(1);
+    }
+  }
+  srand(seed);
+
+  int failures = 0;
+  for (int i = optind; i < argc; i++)
+    if (!check_file(argv[i], edits))
+      failures++;
+  if (failures) {
+    cerr << "incremental-check: edits in " << failures
+	 << " files did not give the tokens of a full scan\n";
+    exit(1);
+  }
+  cerr << "incremental-check: " << edits << " edits in each of "
+       << argc - optind << " files gave the tokens of a full scan\n";
+  return 0;
+}
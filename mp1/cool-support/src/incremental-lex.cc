@@ -0,0 +1,91 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  incremental-lex.cc
+//
+//  Scanning again around an edit (see incremental-lex.h), with a
+//  cool_scanner over the text in place.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "cool-scanner.h"
+#include "incremental-lex.h"
+
+incremental_lexer::incremental_lexer(const char *source, size_t size,
+				     const char *n)
+  : name(n), text(source, source + size), scanned(0)
+{
+  text.push_back('\0');
+  text.push_back('\0');
+  lines.build(source, size);
+
+  cool_scanner scanner;
+  lexed_token t;
+  scanner.open(&text[0], size, name);
+  while ((t.token = scanner.next()) != 0) {
+    t.value = scanner.value();
+    t.start = scanner.token_start();
+    t.end = scanner.token_end();
+    toks.push_back(t);
+    scanned++;
+  }
+}
+
+static bool ends_before(const lexed_token& t, size_t offset)
+{
+  return t.end < offset;
+}
+
+const std::vector<lexed_token>&
+incremental_lexer::edit(size_t start, size_t end, const char *source,
+			size_t n)
+{
+  size_t shift = n - (end - start);   // modulo 2^n if the text shrinks
+
+  text.erase(text.begin() + start, text.begin() + end);
+  text.insert(text.begin() + start, source, source + n);
+  lines.splice(start, end, source, n);
+
+  // the tokens before "keep" are not affected; scanning starts after them
+  size_t keep = std::lower_bound(toks.begin(), toks.end(), start,
+				 ends_before) - toks.begin();
+  size_t from = keep > 0 ? toks[keep - 1].end : 0;
+
+  // old tokens that start after the edit, and where they are now
+  size_t old = keep;
+  while (old < toks.size() && toks[old].start < end)
+    old++;
+
+  std::vector<lexed_token> fresh;
+  cool_scanner scanner;
+  lexed_token t;
+  scanned = 0;
+  scanner.open(&text[from], size() - from, name);
+  while ((t.token = scanner.next()) != 0) {
+    t.value = scanner.value();
+    t.start = from + scanner.token_start();
+    t.end = from + scanner.token_end();
+    scanned++;
+    while (old < toks.size() && toks[old].start + shift < t.start)
+      old++;
+    if (old < toks.size() && toks[old].start + shift == t.start)
+      break;                              // in step with the old tokens
+    fresh.push_back(t);
+  }
+  if (t.token == 0)
+    old = toks.size();
+
+  for (size_t i = old; i < toks.size(); i++) {
+    toks[i].start += shift;
+    toks[i].end += shift;
+  }
+  toks.erase(toks.begin() + keep, toks.begin() + old);
+  toks.insert(toks.begin() + keep, fresh.begin(), fresh.end());
+  return toks;
+}
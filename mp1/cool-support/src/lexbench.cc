@@ -0,0 +1,530 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  lexbench.cc
+//
+//  Measures the lexer: each file is scanned in-process, "-n" times, with
+//  the scanner the lexer is built with, and the best time is reported
+//  as MB/s and tokens/s.  Nothing is printed per token; anything the
+//  scanner's own actions print on stdout is thrown away.
+//
+//      lexbench [-n runs] [-o results] [-c baseline] [-t percent] files
+//
+//  -o writes the MB/s of each file to "results", one "name MB/s" line
+//  each; -c reads such a file and exits 1 if any file was scanned more
+//  than -t percent (10 by default) slower than it says, so a change to
+//  the scanner can be checked against a run before it.  Files are
+//  matched by their last path component.
+//
+//      lexbench -g dir [-s MB] examples.cl ...
+//
+//  writes a corpus to "dir" instead:
+//
+//    scale-<n>mb.cl    the classes of the examples, copied over and over
+//                      with the classes of each copy renamed to Name_1
+//                      ... Name_<renamings> in turn, to 1, 4, 16 ... up
+//                      to -s MB (16 by default)
+//    strings.cl        string constants of up to the 1024 characters
+//                      allowed, with escapes, and some too long
+//    nested.cl         block comments nested thousands deep
+//    identifiers.cl    identifiers thousands of characters long
+//    errors.cl         a file that is mostly lexical errors
+//
+//  The adversarial files are a quarter of -s each.  They are all made
+//  from a fixed seed, so the corpus is the same on every run.
+//
+//  The identifiers of a file come from a vocabulary that does not grow
+//  with it.  The string tables are lists searched from the front
+//  (stringtab.h), so interning a new name for every copy would make the
+//  time to scan a file grow with the square of its size, and the larger
+//  files would measure the tables rather than the scanner.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "cool-parse.h"
+#include "cool-io.h"
+#include "utilities.h"
+#include "scan-input.h"
+
+int curr_lineno = 1;
+const char *curr_filename = "<stdin>";
+FILE *fin;
+
+extern int cool_yylex();
+YYSTYPE cool_yylval;
+
+extern int yy_flex_debug;      // on in a scanner built with flex -d
+
+// needed to link with handle_flags, as in lextest.cc
+int cool_yydebug;
+
+static const double MB = 1024.0 * 1024.0;
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  The corpus
+//
+//////////////////////////////////////////////////////////////////////////////
+
+static std::string read_file(const char *name)
+{
+  FILE *f = fopen(name, "r");
+  if (f == NULL) {
+    cerr << "Could not open input file " << name << endl;
+    exit(1);
+  }
+  std::string text;
+  char block[65536];
+  size_t n;
+  while ((n = fread(block, 1, sizeof(block), f)) > 0)
+    text.append(block, n);
+  fclose(f);
+  return text;
+}
+
+static void write_file(const std::string& dir, const char *name,
+		       const std::string& text)
+{
+  std::string path = dir + "/" + name;
+  FILE *f = fopen(path.c_str(), "w");
+  if (f == NULL || fwrite(text.data(), 1, text.size(), f) != text.size() ||
+      fclose(f) != 0) {
+    cerr << "Could not write " << path << endl;
+    exit(1);
+  }
+}
+
+static bool id_char(char c)
+{
+  return isalnum((unsigned char) c) || c == '_';
+}
+
+//
+// The names that follow the keyword "class" (in any case) in "text".
+//
+static void class_names(const std::string& text, std::set<std::string>& names)
+{
+  for (size_t i = 0; i + 5 < text.size(); i++) {
+    if ((i > 0 && id_char(text[i - 1])) || strncasecmp(&text[i], "class", 5) ||
+	id_char(text[i + 5]))
+      continue;
+    size_t start = i + 5;
+    while (start < text.size() && isspace((unsigned char) text[start]))
+      start++;
+    size_t end = start;
+    while (end < text.size() && id_char(text[end]))
+      end++;
+    if (end > start && isupper((unsigned char) text[start]))
+      names.insert(text.substr(start, end - start));
+    i = end;
+  }
+}
+
+//
+// "text" with every whole word in "names" given "suffix".  Words in
+// strings and comments are renamed too, which the scanner does not mind.
+//
+static void rename_classes(const std::string& text,
+			   const std::set<std::string>& names,
+			   const std::string& suffix, std::string& out)
+{
+  size_t i = 0;
+  while (i < text.size()) {
+    if (!id_char(text[i])) {
+      out += text[i++];
+      continue;
+    }
+    size_t end = i;
+    while (end < text.size() && id_char(text[end]))
+      end++;
+    out.append(text, i, end - i);
+    if (names.count(text.substr(i, end - i)))
+      out += suffix;
+    i = end;
+  }
+}
+
+static const int renamings = 4;
+
+static void scaled_files(const std::string& dir, int max_mb,
+			 const std::vector<std::string>& examples)
+{
+  std::set<std::string> names;
+  for (size_t e = 0; e < examples.size(); e++)
+    class_names(examples[e], names);
+
+  std::string text;
+  int copy = 0;
+  for (int mb = 1; mb <= max_mb; mb *= 4) {
+    while (text.size() < mb * MB) {
+      // copy 0 keeps the examples' own names
+      std::string suffix =
+	copy ? "_" + std::to_string((copy - 1) % renamings + 1) : "";
+      for (size_t e = 0; e < examples.size(); e++)
+	rename_classes(examples[e], names, suffix, text);
+      copy++;
+    }
+    write_file(dir, ("scale-" + std::to_string(mb) + "mb.cl").c_str(), text);
+  }
+}
+
+static std::mt19937 rng(20261018);
+
+static int pick(int n)
+{
+  return rng() % n;
+}
+
+static std::string random_word(int len)
+{
+  static const char letters[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+  std::string w(1, 'a' + pick(26));
+  while ((int) w.size() < len)
+    w += letters[pick(sizeof(letters) - 1)];
+  return w;
+}
+
+//
+// String constants of up to the longest allowed, with an escape every
+// so often; one in 16 is too long and is an error.
+//
+static std::string strings_file(size_t size)
+{
+  static const char *escapes[] = { "\\n", "\\t", "\\\\", "\\\"", "\\b",
+				   "\\f", "\\q", "\\\n" };
+  std::string text = "class Strings {\n";
+  for (int n = 0; text.size() < size; n++) {
+    int len = (n % 16 == 15) ? 1024 + pick(4096) : 1 + pick(1023);
+    text += "  s" + std::to_string(n % 64) + " : String <- \"";
+    for (int i = 0; i < len; ) {
+      if (pick(32) == 0) {
+	text += escapes[pick(8)];
+	i++;
+      } else {
+	int run = 1 + pick(24);
+	text += random_word(run);
+	text += ' ';
+	i += run + 1;
+      }
+    }
+    text += "\";\n";
+  }
+  return text + "};\n";
+}
+
+//
+// Block comments nested thousands deep, with some text and line
+// comments at each level, between ordinary class definitions.
+//
+static std::string nested_file(size_t size)
+{
+  std::string text;
+  for (int n = 0; text.size() < size; n++) {
+    int depth = 1000 + pick(9000);
+    for (int d = 0; d < depth; d++) {
+      text += "(*";
+      if (pick(8) == 0)
+	text += " " + random_word(1 + pick(12)) + " -- * ( ) *\n";
+    }
+    for (int d = 0; d < depth; d++)
+      text += pick(16) ? "*)" : "*)\n";
+    text += "\nclass C" + std::to_string(n) + " { x : Int <- " +
+	    std::to_string(n) + "; };\n";
+  }
+  return text;
+}
+
+//
+// Identifiers and type names of 1K to 64K characters, past the 16K
+// that flex reads at a time.
+//
+static std::string identifiers_file(size_t size)
+{
+  std::string text;
+  while (text.size() < size) {
+    std::string type = random_word(1024 + pick(65536));
+    type[0] = 'A' + pick(26);
+    text += "class " + type + " {\n";
+    for (int f = 0; f < 4; f++)
+      text += "  " + random_word(1024 + pick(65536)) + " : " + type + ";\n";
+    text += "};\n";
+  }
+  return text;
+}
+
+//
+// Mostly errors: characters that start no token, strings that run
+// into a newline or hold a NUL, and *) outside a comment, with a few
+// good tokens between them.
+//
+static std::string errors_file(size_t size)
+{
+  static const char bad[] = "!#$%^&?[]`|\\>_'";
+  std::vector<std::string> words;
+  for (int i = 0; i < 64; i++)
+    words.push_back(random_word(1 + pick(10)));
+
+  std::string text;
+  while (text.size() < size) {
+    switch (pick(6)) {
+    case 0:
+    case 1:
+      for (int i = 1 + pick(8); i > 0; i--)
+	text += bad[pick(sizeof(bad) - 1)];
+      break;
+    case 2:
+      text += "\"" + random_word(1 + pick(40)) + "\n";
+      break;
+    case 3:
+      text += "\"" + random_word(1 + pick(20));
+      text += '\0';
+      text += random_word(1 + pick(20)) + "\"";
+      break;
+    case 4:
+      text += "*)";
+      break;
+    case 5:
+      text += words[pick(64)] + " <- " + std::to_string(pick(1000));
+      break;
+    }
+    text += pick(8) ? " " : "\n";
+  }
+  return text;
+}
+
+static void generate(const std::string& dir, int max_mb, int nfiles,
+		     char **files)
+{
+  std::vector<std::string> examples;
+  for (int i = 0; i < nfiles; i++)
+    examples.push_back(read_file(files[i]));
+  if (examples.empty()) {
+    cerr << "lexbench -g: no example files to build the corpus from\n";
+    exit(1);
+  }
+  if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST) {
+    cerr << "Could not create " << dir << endl;
+    exit(1);
+  }
+
+  size_t size = max_mb * MB / 4;
+  if (size < MB)
+    size = MB;
+  scaled_files(dir, max_mb, examples);
+  write_file(dir, "strings.cl", strings_file(size));
+  write_file(dir, "nested.cl", nested_file(size));
+  write_file(dir, "identifiers.cl", identifiers_file(size));
+  write_file(dir, "errors.cl", errors_file(size));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Measuring
+//
+//////////////////////////////////////////////////////////////////////////////
+
+struct bench_result {
+  std::string name;
+  double mb;
+  long tokens;
+  long errors;
+  double seconds;                 // the best of the runs
+};
+
+static double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void scan_file(const char *file, int runs, bench_result& r)
+{
+  const char *base = strrchr(file, '/');
+  r.name = base ? base + 1 : file;
+  r.seconds = 0;
+
+  for (int run = 0; run < runs; run++) {
+    fin = fopen(file, "r");
+    if (fin == NULL) {
+      cerr << "Could not open input file " << file << endl;
+      exit(1);
+    }
+    struct stat st;
+    fstat(fileno(fin), &st);
+    r.mb = st.st_size / MB;
+    r.tokens = r.errors = 0;
+
+    double start = now();
+    curr_lineno = 1;
+    scan_input(fin);
+    int token;
+    while ((token = cool_yylex()) != 0) {
+      r.tokens++;
+      if (token == ERROR)
+	r.errors++;
+    }
+    end_scan_input();
+    double seconds = now() - start;
+
+    fclose(fin);
+    if (run == 0 || seconds < r.seconds)
+      r.seconds = seconds;
+  }
+}
+
+static void report(const std::vector<bench_result>& results)
+{
+  char line[200];
+  double mb = 0, seconds = 0;
+  long tokens = 0;
+
+  snprintf(line, sizeof(line), "%-24s %9s %10s %9s %9s %12s\n",
+	   "file", "MB", "tokens", "errors", "MB/s", "tokens/s");
+  cout << line;
+  for (size_t i = 0; i < results.size(); i++) {
+    const bench_result& r = results[i];
+    snprintf(line, sizeof(line), "%-24s %9.2f %10ld %9ld %9.1f %12.0f\n",
+	     r.name.c_str(), r.mb, r.tokens, r.errors, r.mb / r.seconds,
+	     r.tokens / r.seconds);
+    cout << line;
+    mb += r.mb;
+    seconds += r.seconds;
+    tokens += r.tokens;
+  }
+  snprintf(line, sizeof(line), "%-24s %9.2f %10ld %9s %9.1f %12.0f\n",
+	   "total", mb, tokens, "", mb / seconds, tokens / seconds);
+  cout << line;
+}
+
+static void write_results(const char *file,
+			  const std::vector<bench_result>& results)
+{
+  FILE *f = fopen(file, "w");
+  if (f == NULL) {
+    cerr << "Could not write " << file << endl;
+    exit(1);
+  }
+  for (size_t i = 0; i < results.size(); i++)
+    fprintf(f, "%s %.1f\n", results[i].name.c_str(),
+	    results[i].mb / results[i].seconds);
+  fclose(f);
+}
+
+//
+// Whether every file of "baseline" that was scanned again was at most
+// "percent" slower than it was then.
+//
+static bool check_results(const char *baseline, double percent,
+			  const std::vector<bench_result>& results)
+{
+  FILE *f = fopen(baseline, "r");
+  if (f == NULL) {
+    cerr << "Could not open baseline " << baseline << endl;
+    exit(1);
+  }
+  std::map<std::string, double> before;
+  char name[1024];
+  double rate;
+  while (fscanf(f, "%1023s %lf", name, &rate) == 2)
+    before[name] = rate;
+  fclose(f);
+
+  bool ok = true;
+  for (size_t i = 0; i < results.size(); i++) {
+    const bench_result& r = results[i];
+    if (!before.count(r.name))
+      continue;
+    double was = before[r.name], is = r.mb / r.seconds;
+    if (is < was * (1 - percent / 100)) {
+      char line[200];
+      snprintf(line, sizeof(line), "%s: %.1f MB/s, down from %.1f (%.1f%%)\n",
+	       r.name.c_str(), is, was, 100 * (was - is) / was);
+      cerr << line;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+int main(int argc, char **argv)
+{
+  int runs = 3, max_mb = 16;
+  const char *corpus = NULL, *results_file = NULL, *baseline = NULL;
+  double percent = 10;
+  int c;
+
+  while ((c = getopt(argc, argv, "n:g:s:o:c:t:")) != -1)
+    switch (c) {
+    case 'n': runs = atoi(optarg); break;
+    case 'g': corpus = optarg; break;
+    case 's': max_mb = atoi(optarg); break;
+    case 'o': results_file = optarg; break;
+    case 'c': baseline = optarg; break;
+    case 't': percent = atof(optarg); break;
+    default:
+      cerr << "usage: lexbench [-n runs] [-o results] [-c baseline] "
+	      "[-t percent] files\n"
+	      "       lexbench -g dir [-s MB] examples.cl ...\n";
+      exit(1);
+    }
+  if (runs < 1)
+    runs = 1;
+  yy_flex_debug = 0;
+  if (max_mb < 1)
+    max_mb = 1;
+
+  if (corpus) {
+    generate(corpus, max_mb, argc - optind, argv + optind);
+    exit(0);
+  }
+
+  //
+  // The scanner's actions may print; that goes to /dev/null, and
+  // stdout is put back for the report.
+  //
+  fflush(stdout);
+  int saved_stdout = dup(1);
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, 1);
+  close(null);
+
+  std::vector<bench_result> results;
+  for (int i = optind; i < argc; i++) {
+    results.push_back(bench_result());
+    scan_file(argv[i], runs, results.back());
+  }
+
+  fflush(stdout);
+  dup2(saved_stdout, 1);
+  close(saved_stdout);
+
+  report(results);
+  cout.flush();
+  if (results_file)
+    write_results(results_file, results);
+  if (baseline && !check_results(baseline, percent, results))
+    exit(1);
+  exit(0);
+}
@@ -18,6 +18,9 @@
 #include <unistd.h>     // for getopt
 #include "cool-parse.h" // bison-generated file; defines tokens
 #include "utilities.h"
+#include "token-stream.h"
+#include "phase-timer.h"
+#include "scan-input.h"
 
 //
 //  The lexer keeps this global variable up to date with the line number
@@ -41,6 +44,11 @@ extern int optind;  // used for option processing (man 3 getopt for more info)
 //
 extern int yy_flex_debug;      // Flex debugging; see flex documentation.
 
+//
+//  Option -B writes the tokens in the binary form of token-stream.h.
+//
+extern int binary_tokens;
+
 void handle_flags(int argc, char *argv[]);
 
 //
@@ -60,6 +68,9 @@ int main(int argc, char** argv) {
 	int token;
 	
 	handle_flags(argc,argv);
+	buffer_cout();
+	TokenWriter *binary = binary_tokens ? new TokenWriter(cout) : NULL;
+	phase_scope *timing = new phase_scope(lex_phase);
 
 	while (optind < argc) {
 	    fin = fopen(argv[optind], "r");
@@ -72,17 +83,33 @@ int main(int argc, char** argv) {
             // this counter, so let's make the stand-alone lexer
             // do the same thing
             curr_lineno = 1;
+	    scan_input(fin);
 
 	    //
 	    // Scan and print all tokens.
 	    //
-	    cout << "#name \"" << argv[optind] << "\"" << endl;
+	    //
+	    // cout is flushed into stdio after each token (no system call;
+	    // see buffer_cout) to keep its lines in order with anything the
+	    // lexer's own actions print on stdout.
+	    //
+	    if (binary)
+		binary->name(argv[optind]);
+	    else
+		cout << "#name \"" << argv[optind] << "\"\n";
+	    cout.flush();
 	    while ((token = cool_yylex()) != 0) {
-		dump_cool_token(cout, curr_lineno, token, cool_yylval);
+		if (binary)
+		    binary->token(curr_lineno, token, cool_yylval);
+		else
+		    dump_cool_token(cout, curr_lineno, token, cool_yylval);
+		cout.flush();
 	    }
+	    end_scan_input();
 	    fclose(fin);
 	    optind++;
 	}
+	delete timing;
 	exit(0);
 }
 
@@ -0,0 +1,68 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  line-index.cc
+//
+//  The line starts of line-index.h.  The newlines are found with
+//  memchr, which the C library compares a vector at a time.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <algorithm>
+#include "line-index.h"
+
+void line_index::build(const char *text, size_t size)
+{
+  const char *p = text, *end = text + size;
+
+  starts.clear();
+  starts.push_back(0);
+  while (p < end && (p = (const char *) memchr(p, '\n', end - p)) != NULL)
+    starts.push_back(++p - text);
+}
+
+//
+// A line starts after each newline, so the lines that start in
+// (start, old_end] began after a newline of the text replaced; those
+// after it move with the rest of the text.
+//
+void line_index::splice(size_t start, size_t old_end, const char *text,
+			size_t size)
+{
+  std::vector<size_t>::iterator first, last;
+  first = std::upper_bound(starts.begin(), starts.end(), start);
+  last = std::upper_bound(first, starts.end(), old_end);
+
+  std::vector<size_t> added;
+  for (size_t i = 0; i < size; i++)
+    if (text[i] == '\n')
+      added.push_back(start + i + 1);
+
+  size_t shift = size - (old_end - start);     // modulo 2^n if shorter
+  for (std::vector<size_t>::iterator l = last; l != starts.end(); l++)
+    *l += shift;
+  starts.insert(starts.erase(first, last), added.begin(), added.end());
+}
+
+int line_index::line(size_t offset, int from) const
+{
+  size_t l = from < 1 ? 0 : from - 1;
+
+  // a step or two forward covers tokens taken in order
+  for (int steps = 0; l + 1 < starts.size() && starts[l + 1] <= offset; l++)
+    if (++steps == 4)
+      return std::upper_bound(starts.begin() + l, starts.end(), offset)
+	     - starts.begin();
+  return l + 1;
+}
+
+int line_index::column(size_t offset) const
+{
+  return offset - starts[line(offset) - 1] + 1;
+}
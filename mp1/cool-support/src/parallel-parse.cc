@@ -0,0 +1,183 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  parallel-parse.cc
+//
+//  frontend -j: one parse per source file on a work-stealing pool (see
+//  parallel-parse.h).  A job scans its file into a vector of tokens and
+//  runs cool_yyparse on them; the parser's globals are per thread, so
+//  the job then only has to save the tree and errors its thread left.
+//  Each job scans with a cool_scanner of its own, so the threads scan
+//  at the same time as well.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "cool-io.h"
+#include "cool-tree.h"
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "token-stream.h"
+#include "source-scan.h"
+#include "cool-scanner.h"
+#include "work-pool.h"
+#include "phase-timer.h"
+#include "parallel-parse.h"
+
+extern parser_local Program ast_root;
+extern parser_local int omerrs;
+extern parser_local int curr_lineno;
+extern parser_local const char *curr_filename;
+extern parser_local std::ostringstream *parse_errors;
+extern parser_local bool parse_halted;   // more than 20 errors (cool.y)
+
+extern int cool_yyparse();
+
+struct file_parse {
+  char *name;
+  long size;
+  Program program;               // NULL if the parse failed
+  int errors;
+  bool unopened;                 // could not be opened
+  bool empty;                    // had no tokens, so was not parsed
+  bool halted;                   // stopped after too many errors
+  std::ostringstream messages;
+};
+
+// the tokens of the job on this thread
+static parser_local std::vector<scanned_token> *job_tokens;
+static parser_local size_t job_next;
+
+static int job_token()
+{
+  if (job_next == job_tokens->size())
+    return 0;
+  scanned_token& t = (*job_tokens)[job_next++];
+  cool_yylval = t.value;
+  curr_lineno = t.lineno;
+  curr_filename = t.filename;
+  return t.token;
+}
+
+// the tokens of one file, without the final 0, on a scanner of its own;
+// false if it cannot be opened
+static bool scan_file(char *name, std::vector<scanned_token>& tokens)
+{
+  phase_scope timing(lex_phase);
+  FILE *f = fopen(name, "r");
+  if (f == NULL)
+    return false;
+  cool_scanner scanner;
+  size_t n = 0;
+
+  scanner.open(f, name);
+  do
+    tokens.resize(n + token_batch);
+  while ((n += scanner.scan(&tokens[n], token_batch)) == tokens.size());
+  tokens.resize(n);
+  fclose(f);
+  return true;
+}
+
+static void parse_tokens(file_parse& f, std::vector<scanned_token>& tokens)
+{
+  job_tokens = &tokens;
+  job_next = 0;
+  ast_root = NULL;
+  omerrs = 0;
+  curr_lineno = 0;
+  curr_filename = f.name;
+  parse_errors = &f.messages;
+  parse_halted = false;
+  set_token_source(job_token);
+  cool_yyparse();
+  parse_errors = NULL;
+
+  f.program = ast_root;
+  f.errors = omerrs;
+  f.halted = parse_halted;
+}
+
+static void parse_file(file_parse& f)
+{
+  std::vector<scanned_token> tokens;
+  f.unopened = !scan_file(f.name, tokens);
+  if (f.unopened) {
+    f.messages << "Could not open input file " << f.name << "\n";
+    return;
+  }
+  f.empty = tokens.empty();
+  if (!f.empty)
+    parse_tokens(f, tokens);
+}
+
+void parse_files_parallel(char **files, int nfiles, int nthreads)
+{
+  std::vector<file_parse> parses(nfiles);
+  std::vector<int> jobs;
+
+  for (int i = 0; i < nfiles; i++) {
+    struct stat st;
+    parses[i].name = files[i];
+    parses[i].size = stat(files[i], &st) == 0 ? st.st_size : 0;
+    jobs.push_back(i);
+  }
+  // biggest first, so that the pool deals them out evenly
+  std::stable_sort(jobs.begin(), jobs.end(), [&](int a, int b) {
+    return parses[a].size > parses[b].size;
+  });
+
+  {
+    phase_scope timing(parse_phase);
+    share_string_tables();
+    work_pool(nthreads).run(jobs, [&](int i) { parse_file(parses[i]); });
+
+    //
+    // The files are one program, so a file with no tokens adds nothing
+    // to it and is not parsed.  If none has any, the end of the input
+    // is parsed as the end of the last one, as when they are parsed in
+    // turn.
+    //
+    if (std::all_of(parses.begin(), parses.end(),
+		    [](const file_parse& f) { return f.empty; })) {
+      std::vector<scanned_token> none;
+      parse_tokens(parses.back(), none);
+    }
+  }
+
+  //
+  // Every file's errors are printed, in the order of the command line,
+  // before giving up on a file that had too many.  A file that could
+  // not be opened stops the compiler where it comes, after the errors
+  // of the files before it, as it does when they are parsed in turn.
+  //
+  Classes classes = NULL;
+  bool halted = false;
+  omerrs = 0;
+  for (int i = 0; i < nfiles; i++) {
+    file_parse& f = parses[i];
+    cerr << f.messages.str();
+    if (f.unopened)
+      exit(1);
+    omerrs += f.errors;
+    halted = halted || f.halted;
+    if (!f.program)
+      continue;
+    classes = classes ? append_Classes(classes, f.program->get_classes())
+		      : f.program->get_classes();
+    curr_lineno = f.program->get_line_number();
+  }
+  if (halted)
+    exit(1);
+  ast_root = program(classes ? classes : nil_Classes());
+}
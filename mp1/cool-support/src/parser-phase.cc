@@ -18,30 +18,47 @@
 #include "cool-tree.h"
 #include "utilities.h"  // for fatal_error
 #include "cool-parse.h"
+#include "ast-census.h"
+#include "ast-binary.h"
+#include "token-stream.h"
+#include "phase-timer.h"
 
 //
 // These globals keep everything working.
 //
 FILE *token_file = stdin;		// we read from this file
-extern Classes parse_results;	 // list of classes; used for multiple files 
-extern Program ast_root;	 // the AST produced by the parse
+extern parser_local Classes parse_results; // list of classes; used for multiple files 
+extern parser_local Program ast_root;	 // the AST produced by the parse
 
-int curr_lineno;               // needed for lexical analyzer
-const char *curr_filename = "<stdin>";
+parser_local int curr_lineno;  // needed for lexical analyzer
+parser_local const char *curr_filename = "<stdin>";
 
-extern int omerrs;             // a count of lex and parse errors
+extern parser_local int omerrs; // a count of lex and parse errors
+extern int dump_census;        // -C: print AST statistics on cerr
+extern int binary_ast;         // -b: write the AST in binary
 
 extern int cool_yyparse();
 void handle_flags(int argc, char *argv[]);
 
 int main(int argc, char *argv[]) {
     handle_flags(argc, argv);
-    cool_yyparse();
+    buffer_cout();
+    open_token_stream(token_file);
+    {
+	phase_scope timing(parse_phase);
+	cool_yyparse();
+    }
     if (omerrs != 0) {
 	cerr << "Compilation halted due to lex and parse errors\n";
 	exit(1);
     }
-    ast_root->dump_with_types(cout,0);
+    if (dump_census)
+	ast_census(ast_root, cerr);
+    phase_scope timing(dump_phase);
+    if (binary_ast)
+	dump_binary_ast(cout, ast_root);
+    else
+	ast_root->dump_with_types(cout,0);
     return 0;
 }
 
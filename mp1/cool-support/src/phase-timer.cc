@@ -0,0 +1,250 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  phase-timer.cc
+//
+//  Measuring phase_scopes and reporting them (see phase-timer.h).
+//
+//  Each thread keeps the scope it is in, so that a scope entered on
+//  the scanner thread of frontend -L is not counted as part of the
+//  parse.  The totals of a timer are shared between threads and are
+//  updated under a lock, which is only taken while timing.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <mutex>
+#include <new>
+#include "cool-io.h"
+#include "phase-timer.h"
+
+phase_timer lex_phase("lex");
+phase_timer parse_phase("parse");
+phase_timer load_phase("load AST");
+phase_timer dump_phase("dump AST");
+phase_timer semant_phase("semant");
+phase_timer cgen_phase("cgen");
+phase_timer intern_scope("string interning");
+phase_timer symtab_scope("symbol table");
+
+static phase_timer total_phase("total");
+
+static phase_timer *timers;               // in order of first use
+static phase_timer **last_timer = &timers;
+static std::mutex timers_lock;
+
+static thread_local phase_scope *current; // innermost scope of this thread
+
+//
+// Allocations are counted per thread, like CPU time, and only while
+// timing; otherwise operator new is the usual malloc.  Without
+// PHASE_TIMING operator new is the library's and they stay 0.
+//
+static thread_local long thread_allocs, thread_alloc_bytes;
+
+#ifdef PHASE_TIMING
+void *operator new(size_t n)
+{
+  if (time_phases) {
+    thread_allocs++;
+    thread_alloc_bytes += n;
+  }
+  void *p = malloc(n ? n : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+#endif
+
+static long clock_ns(clockid_t clock)
+{
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static long max_rss_kb()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss;
+}
+
+void phase_scope::start()
+{
+  outer = current;
+  current = this;
+  allocs = thread_allocs;
+  alloc_bytes = thread_alloc_bytes;
+  rss = max_rss_kb();
+  cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+  wall = clock_ns(CLOCK_MONOTONIC);
+}
+
+void phase_scope::stop()
+{
+  long wall_end = clock_ns(CLOCK_MONOTONIC);
+  long cpu_end = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+  long rss_end = max_rss_kb();
+
+  current = outer;
+  std::lock_guard<std::mutex> hold(timers_lock);
+  if (!timer->used) {
+    timer->used = true;
+    timer->parent = outer ? outer->timer : NULL;
+    *last_timer = timer;
+    last_timer = &timer->next;
+  }
+  timer->calls++;
+  timer->wall_ns += wall_end - wall;
+  timer->cpu_ns += cpu_end - cpu;
+  timer->rss_kb += rss_end - rss;
+  timer->allocs += thread_allocs - allocs;
+  timer->alloc_bytes += thread_alloc_bytes - alloc_bytes;
+}
+
+//////////////////////////////////////////////////////////////////
+//
+//  Reporting
+//
+//  A timer is recorded when its first scope ends, so a parent comes
+//  after its children in the list; the report walks it as a tree.
+//
+//////////////////////////////////////////////////////////////////
+
+static const char *program_name;
+static const char *json_filename;
+static phase_scope *total_scope;
+
+static void print_timers(phase_timer *parent, int depth,
+			 void (*print)(phase_timer *, int))
+{
+  for (phase_timer *t = timers; t; t = t->next)
+    if (t->parent == parent) {
+      print(t, depth);
+      print_timers(t, depth + 1, print);
+    }
+}
+
+static void print_row(phase_timer *t, int depth)
+{
+  char line[160];
+  char allocs[24] = "-", alloc_kb[24] = "-";   // not counted
+#ifdef PHASE_TIMING
+  snprintf(allocs, sizeof(allocs), "%ld", t->allocs);
+  snprintf(alloc_kb, sizeof(alloc_kb), "%ld", t->alloc_bytes / 1024);
+#endif
+  snprintf(line, sizeof(line), "%*s%-*s %8ld %10.2f %10.2f %9ld %10s %10s\n",
+	   2 * depth, "", 24 - 2 * depth, t->name, t->calls,
+	   t->wall_ns / 1e6, t->cpu_ns / 1e6, t->rss_kb, allocs, alloc_kb);
+  cerr << line;
+}
+
+static FILE *json;
+static bool json_first;
+
+// s as a JSON string, in quotes
+static void print_json_string(const char *s)
+{
+  putc('"', json);
+  for (; *s; s++) {
+    unsigned char c = *s;
+    if (c == '"' || c == '\\')
+      fprintf(json, "\\%c", c);
+    else if (c < ' ')
+      fprintf(json, "\\u%04x", c);
+    else
+      putc(c, json);
+  }
+  putc('"', json);
+}
+
+static void print_json(phase_timer *t, int depth)
+{
+  fprintf(json, "%s\n    {\"name\": ", json_first ? "" : ",");
+  print_json_string(t->name);
+  fprintf(json, ", \"parent\": ");
+  if (t->parent)
+    print_json_string(t->parent->name);
+  else
+    fprintf(json, "null");
+  fprintf(json, ", \"depth\": %d, \"calls\": %ld, \"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+	  "\"peak_rss_growth_kb\": %ld",
+	  depth, t->calls, t->wall_ns / 1e6, t->cpu_ns / 1e6, t->rss_kb);
+#ifdef PHASE_TIMING
+  fprintf(json, ", \"allocs\": %ld, \"alloc_bytes\": %ld}", t->allocs, t->alloc_bytes);
+#else
+  fprintf(json, ", \"allocs\": null, \"alloc_bytes\": null}");
+#endif
+  json_first = false;
+}
+
+//
+// The scopes of the thread that called exit, from the innermost out to
+// the total, which the stack will not unwind.
+//
+void end_open_scopes()
+{
+  while (current && current != total_scope)
+    current->stop();
+}
+
+static void report_phases()
+{
+  end_open_scopes();
+  delete total_scope;            // ends the total
+  total_scope = NULL;
+  time_phases = 0;
+
+  std::lock_guard<std::mutex> hold(timers_lock);
+  if (json_filename) {
+    json = fopen(json_filename, "w");
+    if (json == NULL) {
+      cerr << "Cannot open timing report file " << json_filename << "\n";
+      return;
+    }
+    fprintf(json, "{\n  \"program\": ");
+    print_json_string(program_name);
+    fprintf(json, ",\n  \"phases\": [");
+    json_first = true;
+    print_timers(NULL, 0, print_json);
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+  } else {
+    char head[160];
+    snprintf(head, sizeof(head), "%-24s %8s %10s %10s %9s %10s %10s\n",
+	     program_name, "calls", "wall ms", "cpu ms", "+rss KB",
+	     "allocs", "alloc KB");
+    cerr << head;
+    print_timers(NULL, 0, print_row);
+  }
+}
+
+void time_phases_until_exit(const char *program, const char *json_file)
+{
+  const char *slash = strrchr(program, '/');
+  program_name = slash ? slash + 1 : program;
+  json_filename = json_file;
+  time_phases = 1;
+  total_scope = new phase_scope(total_phase);
+  atexit(report_phases);
+}
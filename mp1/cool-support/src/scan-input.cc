@@ -0,0 +1,97 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  scan-input.cc
+//
+//  Whole-file input for the flex scanner (see scan-input.h).
+//
+//  yy_scan_buffer wants the text followed by two NULs, its end-of-buffer
+//  marks.  NULs inside the file are scanned as characters, as they are
+//  when streaming, since flex compares their position with the length.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "scan-input.h"
+
+// in cool-lex.cc
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE yy_scan_buffer(char *base, size_t size);
+extern void yy_delete_buffer(YY_BUFFER_STATE b);
+extern void yyrestart(FILE *input_file);
+
+static YY_BUFFER_STATE file_buffer;     // NULL when streaming
+static char *file_text;
+
+char *read_scan_text(FILE *f, size_t& size)
+{
+  struct stat st;
+  int fd = fileno(f);
+
+  if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0 ||
+      st.st_size > INT_MAX - 2 || lseek(fd, 0, SEEK_CUR) != 0)
+    return NULL;
+
+  char *text = (char *) malloc(st.st_size + 2);
+  if (!text)
+    return NULL;
+  size = 0;
+  ssize_t n;
+  while (size < (size_t) st.st_size &&
+	 (n = read(fd, text + size, st.st_size - size)) > 0)
+    size += n;
+  text[size] = text[size + 1] = '\0';
+  return text;
+}
+
+char *read_all_text(FILE *f, size_t& size)
+{
+  char *text = f ? read_scan_text(f, size) : NULL;
+  if (text)
+    return text;
+
+  size_t room = 65536;
+  size_t n;
+  size = 0;
+  text = (char *) malloc(room);
+  while (f && text && (n = fread(text + size, 1, room - size - 2, f)) > 0) {
+    size += n;
+    if (room - size - 2 == 0)
+      text = (char *) realloc(text, room *= 2);
+  }
+  if (text)
+    text[size] = text[size + 1] = '\0';
+  return text;
+}
+
+void scan_input(FILE *f)
+{
+  size_t size;
+
+  end_scan_input();
+  if ((file_text = read_scan_text(f, size)) != NULL) {
+    if ((file_buffer = yy_scan_buffer(file_text, size + 2)) != NULL)
+      return;
+    free(file_text);
+    file_text = NULL;
+  }
+  yyrestart(f);
+}
+
+void end_scan_input()
+{
+  if (!file_buffer)
+    return;
+  yy_delete_buffer(file_buffer);      // leaves the text alone
+  free(file_text);
+  file_buffer = NULL;
+  file_text = NULL;
+}
@@ -0,0 +1,82 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  scanner-engine.cc
+//
+//  One scanner_engine of cool-scanner.h: the flex scanner of
+//  cool-lex.cc, included in a namespace of its own so that its globals
+//  and statics are those of this engine alone.  The Makefile compiles
+//  this file once for each engine, with SCANNER_ENGINE set to its
+//  number, and SCANNER_SOURCE set to hand-lex.cc when the program is
+//  built with the hand-written scanner instead.
+//
+//  The headers the scanners include are included first, outside the
+//  namespace; their guards then keep the scanner from including them
+//  again inside it.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "utilities.h"
+#include "cool-keywords.h"
+#include "string-const.h"
+#include "skip-blanks.h"
+#include "scan-input.h"
+#include "cool-scanner.h"
+
+#ifndef SCANNER_SOURCE
+#define SCANNER_SOURCE "cool-lex.cc"
+#endif
+
+#define ENGINE_NAMESPACE(n) ENGINE_NAMESPACE_(n)
+#define ENGINE_NAMESPACE_(n) scanner_engine_##n
+
+namespace ENGINE_NAMESPACE(SCANNER_ENGINE) {
+
+FILE *fin;
+int curr_lineno = 1;
+YYSTYPE cool_yylval;
+
+#include SCANNER_SOURCE
+
+static YY_BUFFER_STATE file_buffer;     // NULL when streaming
+
+// flex keeps a NUL after the last token it matched, with the byte it
+// replaced in yy_hold_char; that byte is put back, since the text may
+// be the caller's.  hand-lex.cc does not write to the text.
+static void finish()
+{
+  if (file_buffer) {
+#ifdef YY_FLEX_MAJOR_VERSION
+    *yy_c_buf_p = yy_hold_char;
+#endif
+    yy_delete_buffer(file_buffer);
+  }
+  file_buffer = NULL;
+}
+
+static void start(FILE *f, char *text, size_t size)
+{
+  finish();
+  fin = f;
+  curr_lineno = 1;
+  if (!text || (file_buffer = yy_scan_buffer(text, size + 2)) == NULL)
+    yyrestart(f);
+}
+
+static scanner_engine engine(&curr_lineno, &cool_yylval, &yy_flex_debug,
+			     &yytext, &yyleng, cool_yylex, start, finish);
+
+}
@@ -1,11 +1,16 @@
 #include <stdio.h>
 #include "cool-tree.h"
+#include "ast-census.h"
+#include "ast-binary.h"
+#include "phase-timer.h"
 
 extern Program ast_root;      // root of the abstract syntax tree
 FILE *ast_file = stdin;       // we read the AST from standard input
 extern int ast_yyparse(void); // entry point to the AST parser
 
 int cool_yydebug;     // not used, but needed to link with handle_flags
+extern int dump_census;       // -C: print AST statistics on cerr
+extern int binary_ast;        // -b: write the typed AST in binary for cgen
 int curr_lineno;
 char *curr_filename;
 
@@ -13,8 +18,24 @@ void handle_flags(int argc, char *argv[]);
 
 int main(int argc, char *argv[]) {
   handle_flags(argc,argv);
-  ast_yyparse();
-  ast_root->semant();
-  ast_root->dump_with_types(cout,0);
+  buffer_cout();
+  {
+    phase_scope timing(load_phase);
+    if (is_binary_ast(ast_file))
+      ast_root = read_binary_ast(ast_file);
+    else
+      ast_yyparse();
+  }
+  if (dump_census)
+    ast_census(ast_root, cerr);
+  {
+    phase_scope timing(semant_phase);
+    ast_root->semant();
+  }
+  phase_scope timing(dump_phase);
+  if (binary_ast)
+    dump_binary_ast(cout, ast_root);
+  else
+    ast_root->dump_with_types(cout,0);
 }
 
@@ -0,0 +1,101 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  skip-blanks.cc
+//
+//  White space and comments (see skip-blanks.h).
+//
+//  With SSE2, which every x86-64 has, 16 bytes are compared at once;
+//  elsewhere, and for the last few bytes of the input, a byte at a
+//  time.  White space is looked at a byte at a time for its first few
+//  bytes, since between tokens it is mostly a single blank.  A --
+//  comment is a search for its newline, which memchr already does a
+//  vector at a time.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "skip-blanks.h"
+
+static inline bool is_white(char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');   // \t \n \v \f \r
+}
+
+const char *skip_white_space(const char *p, const char *end)
+{
+  // most runs are a blank or two between tokens
+  for (const char *short_run = p + 8; p < short_run && p < end; p++)
+    if (!is_white(*p))
+      return p;
+#ifdef __SSE2__
+  const __m128i blank = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i four = _mm_set1_epi8(4);
+
+  for (; end - p >= 16; p += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) p);
+    __m128i ctl = _mm_sub_epi8(v, tab);          // \t..\r are 0..4
+    __m128i white = _mm_or_si128(_mm_cmpeq_epi8(v, blank),
+      _mm_cmpeq_epi8(_mm_min_epu8(ctl, four), ctl));
+    unsigned other = ~_mm_movemask_epi8(white) & 0xffff;
+    if (other)
+      return p + __builtin_ctz(other);
+  }
+#endif
+  while (p < end && is_white(*p))
+    p++;
+  return p;
+}
+
+const char *skip_line_comment(const char *p, const char *end)
+{
+  const char *nl = (const char *) memchr(p, '\n', end - p);
+  return nl ? nl : end;
+}
+
+// the first ( or * in [p, end)
+static const char *find_paren_star(const char *p, const char *end)
+{
+#ifdef __SSE2__
+  const __m128i paren = _mm_set1_epi8('(');
+  const __m128i star = _mm_set1_epi8('*');
+
+  for (; end - p >= 16; p += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) p);
+    unsigned hit = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, paren),
+						  _mm_cmpeq_epi8(v, star)));
+    if (hit)
+      return p + __builtin_ctz(hit);
+  }
+#endif
+  while (p < end && *p != '(' && *p != '*')
+    p++;
+  return p;
+}
+
+const char *skip_block_comment(const char *p, const char *end, int& depth)
+{
+  while (depth > 0) {
+    p = find_paren_star(p, end);
+    if (end - p < 2)
+      return end;
+    if (p[0] == '(' && p[1] == '*') {
+      depth++;
+      p += 2;
+    } else if (p[0] == '*' && p[1] == ')') {
+      depth--;
+      p += 2;
+    } else
+      p++;
+  }
+  return p;
+}
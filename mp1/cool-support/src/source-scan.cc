@@ -0,0 +1,197 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  source-scan.cc
+//
+//  The token source of the in-process drivers (see source-scan.h).
+//
+//  parse_files can run the scanner on a thread of its own, passing
+//  tokens to the parser through a lock-free ring (spsc-ring.h) so that
+//  lexing and parsing overlap.  The scanner thread writes only
+//  scan_lineno, scan_yylval and scan_filename; the parser sees
+//  curr_lineno, curr_filename and cool_yylval set from each token as it
+//  takes it, exactly as in the single-threaded case.  Errors and line
+//  numbers therefore do not depend on how far ahead the scanner has got.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include "cool-io.h"
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "token-stream.h"
+#include "spsc-ring.h"
+#include "source-scan.h"
+#include "phase-timer.h"
+#include "scan-input.h"
+
+FILE *fin;                       // the scanner reads from this file
+int scan_lineno = 1;             // the scanner's curr_lineno
+YYSTYPE scan_yylval;             // the scanner's cool_yylval
+static const char *scan_filename = "<stdin>";
+
+extern parser_local int curr_lineno;   // the parser's, for the token it has
+extern parser_local const char *curr_filename;
+
+extern int cool_yylex();
+extern int cool_yyparse();
+
+//
+// The source files named on the command line are scanned one after the
+// other as a single token stream, as lextest prints them; the file name
+// and line number are reset for each, as lextest does.
+//
+static char **files;
+static int nfiles;
+
+static bool open_next_file()
+{
+  end_scan_input();
+  if (fin && fin != stdin)
+    fclose(fin);
+  fin = NULL;
+  if (nfiles == 0)
+    return false;
+  fin = fopen(*files, "r");
+  if (fin == NULL) {
+    cerr << "Could not open input file " << *files << "\n";
+    exit(1);
+  }
+  scan_filename = *files;
+  scan_lineno = 1;
+  files++;
+  nfiles--;
+  scan_input(fin);
+  return true;
+}
+
+static int scan()
+{
+  int token;
+  while ((token = cool_yylex()) == 0)
+    if (!open_next_file())
+      return 0;
+  return token;
+}
+
+int scan_batch(scanned_token *tokens, int max)
+{
+  phase_scope timing(lex_phase);
+  int n = 0;
+
+  while (n < max) {
+    scanned_token& t = tokens[n++];
+    t.token = scan();
+    t.lineno = scan_lineno;
+    t.filename = scan_filename;
+    t.value = scan_yylval;
+    if (t.token == 0)
+      break;
+  }
+  return n;
+}
+
+//
+// On one thread, the parser takes its tokens from a batch, which is
+// refilled when it has taken them all.  Token 0 stays in the batch, so
+// that it is returned again if the parser asks again.
+//
+// Token 0 leaves curr_lineno at that of the last real token, as the
+// parser reading the lexer's output does: the program node gets the
+// line of the last token of the last file, not the line the scanner
+// had reached at the end of it.  curr_filename becomes the last file's
+// name, which the lexer's #name line for it sets even if the file has
+// no tokens.  With no tokens at all the line stays at 0, the parser's.
+//
+static scanned_token batch[token_batch];
+static int batch_next, batch_size;
+
+int scan_token()
+{
+  if (batch_next == batch_size) {
+    batch_size = scan_batch(batch, token_batch);
+    batch_next = 0;
+  }
+  scanned_token& t = batch[batch_next];
+  if (t.token == 0) {
+    curr_filename = t.filename;
+    return 0;
+  }
+  batch_next++;
+  cool_yylval = t.value;
+  curr_lineno = t.lineno;
+  curr_filename = t.filename;
+  return t.token;
+}
+
+//
+// On two threads, the scanner thread pushes each token with everything the
+// parser needs to know about it, ending with token 0.
+//
+static spsc_ring<scanned_token, 4096> token_ring;
+
+static void scanner_thread()
+{
+  scanned_token tokens[token_batch];
+  int n;
+
+  do {
+    n = scan_batch(tokens, token_batch);
+    for (int i = 0; i < n; i++)
+      if (!token_ring.push(tokens[i]))
+	return;
+  } while (tokens[n - 1].token != 0);
+}
+
+// the token source on the parser's side of the ring
+static int ring_token()
+{
+  static bool at_end = false;
+  if (at_end)
+    return 0;
+  scanned_token t = token_ring.pop();
+  if (t.token == 0) {             // the line of the last token, as above
+    curr_filename = t.filename;
+    at_end = true;
+    return 0;
+  }
+  cool_yylval = t.value;
+  curr_lineno = t.lineno;
+  curr_filename = t.filename;
+  return t.token;
+}
+
+void scan_files(char **names, int n)
+{
+  files = names;
+  nfiles = n;
+  if (nfiles == 0)
+    fin = stdin;
+  else
+    open_next_file();
+}
+
+void parse_files(bool threaded)
+{
+  phase_scope timing(parse_phase);
+  if (threaded) {
+    // the parser adds file names to stringtable while the scanner adds
+    // identifiers and constants
+    share_string_tables();
+    std::thread scanner(scanner_thread);
+    set_token_source(ring_token);
+    cool_yyparse();
+    token_ring.close();
+    scanner.join();
+  } else {
+    set_token_source(scan_token);
+    cool_yyparse();
+  }
+}
@@ -0,0 +1,134 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  string-const.cc
+//
+//  String constants without string_buf (see string-const.h).
+//
+//  find_string_special compares 16 bytes at a time with each of the
+//  four special characters where SSE2 is available, which is every
+//  x86-64; elsewhere, and for the last few bytes, it goes a byte at a
+//  time.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "stringtab.h"
+#include "string-const.h"
+
+const char *find_string_special(const char *p, const char *end)
+{
+#ifdef __SSE2__
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i nul = _mm_setzero_si128();
+
+  for (; end - p >= 16; p += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) p);
+    __m128i hit = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+      _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, nul)));
+    int mask = _mm_movemask_epi8(hit);
+    if (mask)
+      return p + __builtin_ctz(mask);
+  }
+#endif
+  for (; p < end; p++)
+    if (*p == '"' || *p == '\\' || *p == '\n' || *p == '\0')
+      return p;
+  return end;
+}
+
+static void error(string_const& s, const char *msg)
+{
+  s.token = ERROR;
+  s.value.error_msg = msg;
+}
+
+const char *scan_string_const(const char *p, const char *end,
+			      string_const& s)
+{
+  const char *q = find_string_special(p, end);
+
+  s.newlines = 0;
+  if (q < end && *q == '"') {             // no escapes: intern in place
+    if (q - p >= MAX_STR_CONST)
+      error(s, "String constant too long");
+    else {
+      s.token = STR_CONST;
+      s.value.symbol = stringtable.add_string(p, q - p);
+    }
+    return q + 1;
+  }
+
+  char buf[MAX_STR_CONST];
+  int len = 0;
+  bool too_long = false, has_nul = false;
+
+  for (;;) {
+    int n = q - p;
+    if (len + n >= MAX_STR_CONST)
+      too_long = true;
+    else {
+      memcpy(buf + len, p, n);
+      len += n;
+    }
+    if (q == end) {
+      error(s, "EOF in string constant");
+      return end;
+    }
+
+    char c = *q;
+    p = q + 1;
+    if (c == '"')
+      break;
+    if (c == '\n') {
+      s.newlines++;
+      error(s, "Unterminated string constant");
+      return p;
+    }
+    if (c == '\0') {
+      has_nul = true;
+    } else {                              // a backslash
+      if (p == end) {
+	error(s, "EOF in string constant");
+	return end;
+      }
+      c = *p++;
+      switch (c) {
+      case 'n':  c = '\n'; break;
+      case 't':  c = '\t'; break;
+      case 'b':  c = '\b'; break;
+      case 'f':  c = '\f'; break;
+      case '\n': s.newlines++; break;
+      case '\0': has_nul = true; break;
+      }
+      if (c != '\0') {
+	if (len + 1 >= MAX_STR_CONST)
+	  too_long = true;
+	else
+	  buf[len++] = c;
+      }
+    }
+    q = find_string_special(p, end);
+  }
+
+  if (has_nul)
+    error(s, "String contains null character.");
+  else if (too_long)
+    error(s, "String constant too long");
+  else {
+    s.token = STR_CONST;
+    s.value.symbol = stringtable.add_string(buf, len);
+  }
+  return p;
+}
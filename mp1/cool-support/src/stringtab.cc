@@ -5,11 +5,10 @@
 #include "copyright.h"
 
 #include <assert.h>
+#include <mutex>
 #include "stringtab_functions.h"
 #include "stringtab.h"
 
-extern char *pad(int n);
-
 //
 // Explicit template instantiations.
 // Comment out for versions of g++ prior to 2.7
@@ -34,6 +33,13 @@ ostream& Entry::print(ostream& s) const
   return s << "{" << str << ", " << len << ", " << index << "}\n";
 }
 
+bool string_tables_shared = false;
+static std::mutex string_table_mutex;
+
+void share_string_tables()   { string_tables_shared = true; }
+void lock_string_tables()    { string_table_mutex.lock(); }
+void unlock_string_tables()  { string_table_mutex.unlock(); }
+
 ostream& operator<<(ostream& s, const Entry& sym) 
 {
   return s << sym.get_string();
@@ -67,7 +73,7 @@ Symbol copy_Symbol(const Symbol s)
 
 void dump_Symbol(ostream& s, int n, Symbol sym)
 {
-  s << pad(n) << sym << endl;
+  s << pad(n) << sym << '\n';
 }
 
 StringEntry::StringEntry(const char *s, int l, int i) : Entry(s,l,i) { }
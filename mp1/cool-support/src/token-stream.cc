@@ -0,0 +1,275 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  token-stream.cc
+//
+//  Writer and reader for the binary token stream described in
+//  token-stream.h.  The writer is called by the lexer driver in place
+//  of dump_cool_token; the reader is the parser's yylex (see cool.y),
+//  and hands text streams on to the flex scanner in tokens-lex.cc, or
+//  every call to the token source of an in-process front end.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "cool-io.h"
+#include "cool-tokens.h"
+#include "stringtab.h"
+#include "token-stream.h"
+
+extern parser_local int curr_lineno;
+extern parser_local char *curr_filename;
+extern int cool_yylex();        // tokens-lex.cc, or cool-lex.cc in frontend
+
+static const char token_magic[] = { 0x7f, 'C', 'T', 'O', 'K' };
+
+//////////////////////////////////////////////////////////////////
+//
+//  Writing
+//
+//////////////////////////////////////////////////////////////////
+
+TokenWriter::TokenWriter(ostream& s) : stream(s), line(0)
+{
+  stream.write(token_magic, sizeof(token_magic));
+  stream.put((char) TOKEN_STREAM_VERSION);
+}
+
+void TokenWriter::number(unsigned long n)
+{
+  while (n >= 0x80) {
+    record += (char) (n | 0x80);
+    n >>= 7;
+  }
+  record += (char) n;
+}
+
+void TokenWriter::string(const char *s, int len)
+{
+  number(len);
+  record.append(s, len);
+}
+
+void TokenWriter::symbol(int table, Symbol s)
+{
+  int &i = index[table][s];
+  if (i == 0) {
+    i = index[table].size();
+    number(0);
+    string(s->get_string(), s->get_len());
+  } else {
+    number(i);
+  }
+}
+
+void TokenWriter::name(const char *filename)
+{
+  record.clear();
+  number(0);
+  string(filename, strlen(filename));
+  stream.write(record.data(), record.size());
+}
+
+void TokenWriter::token(int lineno, int token, YYSTYPE yylval)
+{
+  const cool_token_info *t = cool_tokens.lookup(token);
+  long delta = (long) lineno - line;
+
+  record.clear();
+  number(token);
+  number(delta < 0 ? ((unsigned long) -delta << 1) - 1 : (unsigned long) delta << 1);
+  line = lineno;
+
+  switch (t ? t->value : TOKVAL_NONE) {
+  case TOKVAL_ID:    symbol(ID_TABLE, yylval.symbol);  break;
+  case TOKVAL_INT:   symbol(INT_TABLE, yylval.symbol); break;
+  case TOKVAL_STR:   symbol(STR_TABLE, yylval.symbol); break;
+  case TOKVAL_BOOL:  number(yylval.boolean ? 1 : 0);   break;
+  case TOKVAL_ERROR: string(yylval.error_msg, strlen(yylval.error_msg)); break;
+  case TOKVAL_NONE:  break;
+  }
+  stream.write(record.data(), record.size());
+}
+
+//////////////////////////////////////////////////////////////////
+//
+//  Reading
+//
+//  The stream comes down a pipe, so it is read in 64K blocks rather
+//  than all at once.
+//
+//////////////////////////////////////////////////////////////////
+
+class TokenReader {
+private:
+  FILE *file;
+  unsigned char buf[1 << 16];
+  unsigned char *p, *end;
+  std::vector<Symbol> symbols[3];
+  int line;
+
+  void malformed();
+  bool fill();
+  int byte();
+  unsigned long number();
+  const char *string(int& len);
+  Symbol symbol(int table);
+
+public:
+  TokenReader(FILE *f);
+  int next();
+};
+
+// set by open_token_stream; token_reader is NULL for a text stream
+static parser_local TokenReader *token_reader;
+static parser_local int (*token_source)() = cool_yylex;
+
+void TokenReader::malformed()
+{
+  cerr << "malformed binary token stream\n";
+  exit(1);
+}
+
+TokenReader::TokenReader(FILE *f) : file(f), p(buf), end(buf), line(0)
+{
+  for (int i = 0; i < (int) sizeof(token_magic); i++)
+    if (byte() != (unsigned char) token_magic[i])
+      malformed();
+  if (byte() != TOKEN_STREAM_VERSION)
+    malformed();
+}
+
+bool TokenReader::fill()
+{
+  size_t n = fread(buf, 1, sizeof(buf), file);
+  p = buf;
+  end = buf + n;
+  return n > 0;
+}
+
+// the next byte, or EOF at the end of the input
+int TokenReader::byte()
+{
+  if (p == end && !fill())
+    return EOF;
+  return *p++;
+}
+
+unsigned long TokenReader::number()
+{
+  unsigned long n = 0;
+  int shift = 0, c;
+  do {
+    if ((c = byte()) == EOF || shift > 56)
+      malformed();
+    n |= (unsigned long) (c & 0x7f) << shift;
+    shift += 7;
+  } while (c & 0x80);
+  return n;
+}
+
+//
+// Strings are returned in a buffer that is reused by the next call; a
+// string that does not fit is gathered across refills.
+//
+const char *TokenReader::string(int& len)
+{
+  static std::string s;
+  unsigned long n = number();
+
+  s.clear();
+  while (s.size() < n) {
+    if (p == end && !fill())
+      malformed();
+    size_t chunk = end - p;
+    if (chunk > n - s.size())
+      chunk = n - s.size();
+    s.append((const char *) p, chunk);
+    p += chunk;
+  }
+  len = n;
+  return s.c_str();
+}
+
+Symbol TokenReader::symbol(int table)
+{
+  unsigned long i = number();
+  if (i == 0) {
+    int len;
+    const char *s = string(len);
+    switch (table) {
+    case 0: symbols[table].push_back(idtable.add_string(s, len)); break;
+    case 1: symbols[table].push_back(inttable.add_string(s, len)); break;
+    case 2: symbols[table].push_back(stringtable.add_string(s, len)); break;
+    }
+    return symbols[table].back();
+  }
+  if (i > symbols[table].size())
+    malformed();
+  return symbols[table][i-1];
+}
+
+//
+// The next token, after any file names in front of it; 0 at the end.
+//
+int TokenReader::next()
+{
+  int c, len;
+  const char *s;
+
+  while ((c = byte()) != EOF) {
+    p--;
+    int token = number();
+    if (token == 0) {
+      s = string(len);
+      curr_filename = strdup(s);
+      continue;
+    }
+    const cool_token_info *t = cool_tokens.lookup(token);
+    if (!t)
+      malformed();
+    unsigned long z = number();
+    line += (z & 1) ? -(long) ((z + 1) >> 1) : (long) (z >> 1);
+    curr_lineno = line;
+
+    switch (t->value) {
+    case TOKVAL_ID:    cool_yylval.symbol = symbol(0); break;
+    case TOKVAL_INT:   cool_yylval.symbol = symbol(1); break;
+    case TOKVAL_STR:   cool_yylval.symbol = symbol(2); break;
+    case TOKVAL_BOOL:  cool_yylval.boolean = number() != 0; break;
+    case TOKVAL_ERROR:
+      s = string(len);
+      cool_yylval.error_msg = strdup(s);
+      break;
+    case TOKVAL_NONE:  break;
+    }
+    return token;
+  }
+  return 0;
+}
+
+void open_token_stream(FILE *f)
+{
+  int c = getc(f);
+  if (c != EOF)
+    ungetc(c, f);
+  if (c == (unsigned char) token_magic[0])
+    token_reader = new TokenReader(f);
+}
+
+void set_token_source(int (*source)())
+{
+  token_source = source;
+}
+
+int next_cool_token()
+{
+  return token_reader ? token_reader->next() : token_source();
+}
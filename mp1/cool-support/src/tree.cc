@@ -17,7 +17,7 @@
 
 #define yylineno curr_lineno;
 
-extern int yylineno;
+extern parser_local int yylineno;
 
 ///////////////////////////////////////////////////////////////////////////
 //
@@ -13,14 +13,25 @@
 //  This file contains:
 //      fatal_error            print an error message and exit
 //      print_escaped_string   print a string showing escape characters
+//      cool_token_to_string   the name of a cool token
 //      print_cool_token       print a cool token and its semantic value
 //      dump_cool_token        dump a readable token representation
+//      buffer_cout            buffer cout for dumping large outputs
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "cool-io.h"     // for cerr, <<, manipulators
 #include <ctype.h>       // for isprint
+#include <stdio.h>       // for snprintf
+#include <string.h>      // for memcpy, strlen
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <stdlib.h>      // for atexit
+#include <unistd.h>      // for isatty
+#include <streambuf>
 #include "cool-parse.h"  // defines tokens
+#include "cool-tokens.h" // names and values of tokens
 #include "stringtab.h"   // Symbol <-> String conversions
 #include "utilities.h"
 
@@ -32,6 +43,8 @@
 //                      01234567890123456789012345678901234567890123456789012345678901234567890123456789
 static const char *padding = "                                                                                ";      // 80 spaces for padding
 
+extern int compact_dump;   // -k: dump trees without indentation
+
 void fatal_error(char *msg)
 {
    cerr << msg;
@@ -39,133 +52,170 @@ void fatal_error(char *msg)
 }
 
 
+//
+// print_escaped_string writes the bytes that stand for themselves in
+// runs with one ostream::write and looks every other byte up in
+// escape_table.  The table holds the usual backslash escapes, and a
+// backslash and three octal digits for anything else that is not
+// printable ASCII.  (The high bit is tested
+// before isprint, whose argument must be an unsigned char.)
+//
+class escape_table {
+public:
+  unsigned char len[256];       // 0 if the byte needs no escaping
+  char text[256][4];
+  escape_table();
+};
+
+escape_table::escape_table()
+{
+  for (int c = 0; c < 256; c++) {
+    const char *e = NULL;
+    char octal[5];
+    switch (c) {
+    case '\\' : e = "\\\\"; break;
+    case '\"' : e = "\\\""; break;
+    case '\n' : e = "\\n"; break;
+    case '\t' : e = "\\t"; break;
+    case '\b' : e = "\\b"; break;
+    case '\f' : e = "\\f"; break;
+    default:
+      if (c >= 0x80 || !isprint(c)) {
+	snprintf(octal, sizeof(octal), "\\%03o", c);
+	e = octal;
+      }
+    }
+    len[c] = e ? strlen(e) : 0;
+    if (e)
+      memcpy(text[c], e, len[c]);
+  }
+}
+
+static const escape_table escapes;
+
+//
+// Length of the run of bytes at s that need no escaping, at most n.
+// With SSE2 sixteen bytes are checked at a time: a byte is unsafe if it
+// is below ' ' or at least 0x80 (both negative or small as signed
+// chars), DEL, a backslash or a double quote.
+//
+static size_t safe_run(const unsigned char *s, size_t n)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i quote = _mm_set1_epi8('"');
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+    __m128i bad = _mm_or_si128(
+      _mm_or_si128(_mm_cmplt_epi8(v, space), _mm_cmpeq_epi8(v, del)),
+      _mm_or_si128(_mm_cmpeq_epi8(v, backslash), _mm_cmpeq_epi8(v, quote)));
+    int mask = _mm_movemask_epi8(bad);
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+#endif
+  while (i < n && escapes.len[s[i]] == 0)
+    i++;
+  return i;
+}
+
 void print_escaped_string(ostream& str, const char *s)
 {
-  while (*s) {
-    switch (*s) {
-    case '\\' : str << "\\\\"; break;
-    case '\"' : str << "\\\""; break;
-    case '\n' : str << "\\n"; break;
-    case '\t' : str << "\\t"; break;
-    case '\b' : str << "\\b"; break;
-    case '\f' : str << "\\f"; break;
+  const unsigned char *p = (const unsigned char *) s;
+  size_t n = strlen(s);
 
-    default:
-      if (isprint(*s))
-	str << *s;
-      else 
-	// 
-	// Unprintable characters are printed using octal equivalents.
-	// To get the sign of the octal number correct, the character
-	// must be cast to an unsigned char before coverting it to an
-	// integer.
-	//
-	str << '\\' << oct << setfill('0') << setw(3)
-	    << (int) ((unsigned char) (*s))
-	    << dec << setfill(' ');
-      break;
+  while (n > 0) {
+    size_t run = safe_run(p, n);
+    if (run > 0) {
+      str.write((const char *) p, run);
+      p += run;
+      n -= run;
+    }
+    if (n > 0) {
+      str.write(escapes.text[*p], escapes.len[*p]);
+      p++;
+      n--;
     }
-    s++;
   }
 }
 
+//
+// Token names and values come from the table in cool-tokens.h.  Check
+// its numbers against the ones bison gave the %token declarations.
+//
+#define CHECK_TOKEN(tok, num, val) \
+  static_assert(tok == num, "cool-tokens.h does not match cool.y: " #tok);
+COOL_TOKENS(CHECK_TOKEN)
+#undef CHECK_TOKEN
+
 //
 // The following two functions are used for debugging the parser.
 //
 const char *cool_token_to_string(int tok)
 {
-  switch (tok) {
-  case 0:            return("EOF");        break;
-  case (CLASS):      return("CLASS");      break;
-  case (ELSE):       return("ELSE");       break;
-  case (FI):         return("FI");         break;
-  case (IF):         return("IF");         break;
-  case (IN):         return("IN");         break;
-  case (INHERITS):   return("INHERITS");   break;
-  case (LET):        return("LET");        break;
-  case (LOOP):       return("LOOP");       break;
-  case (POOL):       return("POOL");       break;
-  case (THEN):       return("THEN");       break;
-  case (WHILE):      return("WHILE");      break;
-  case (ASSIGN):     return("ASSIGN");     break;
-  case (CASE):       return("CASE");       break;
-  case (ESAC):       return("ESAC");       break;
-  case (OF):         return("OF");         break;
-  case (DARROW):     return("DARROW");     break;
-  case (NEW):        return("NEW");        break;
-  case (STR_CONST):  return("STR_CONST");  break;
-  case (INT_CONST):  return("INT_CONST");  break;
-  case (BOOL_CONST): return("BOOL_CONST"); break;
-  case (TYPEID):     return("TYPEID");     break;
-  case (OBJECTID):   return("OBJECTID");   break;
-  case (ERROR):      return("ERROR");      break;
-  case (LE):         return("LE");         break;
-  case (NOT):        return("NOT");        break;
-  case (ISVOID):     return("ISVOID");     break;
-  case '+': return("'+'"); break;
-  case '/': return("'/'"); break;
-  case '-': return("'-'"); break;
-  case '*': return("'*'"); break;
-  case '=': return("'='"); break;
-  case '<': return("'<'"); break;
-  case '.': return("'.'"); break;
-  case '~': return("'~'"); break;
-  case ',': return("','"); break;
-  case ';': return("';'"); break;
-  case ':': return("':'"); break;
-  case '(': return("'('"); break;
-  case ')': return("')'"); break;
-  case '@': return("'@'"); break;
-  case '{': return("'{'"); break;
-  case '}': return("'}'"); break;
-  default:  return("<Invalid Token>");
-  }
+  const cool_token_info *t = cool_tokens.lookup(tok);
+  return t ? t->name : "<Invalid Token>";
 }
 
-void print_cool_token(int tok)
+static cool_token_value token_value(int tok)
 {
+  const cool_token_info *t = cool_tokens.lookup(tok);
+  return t ? t->value : TOKVAL_NONE;
+}
 
-  cerr << cool_token_to_string(tok);
+void print_cool_token(ostream& out, int tok)
+{
+
+  out << cool_token_to_string(tok);
 
-  switch (tok) {
-  case (STR_CONST):
-    cerr << " = ";
-    cerr << " \"";
-    print_escaped_string(cerr, cool_yylval.symbol->get_string());
-    cerr << "\"";
+  switch (token_value(tok)) {
+  case TOKVAL_STR:
+    out << " = ";
+    out << " \"";
+    print_escaped_string(out, cool_yylval.symbol->get_string());
+    out << "\"";
 #ifdef CHECK_TABLES
     stringtable.lookup_string(cool_yylval.symbol->get_string());
 #endif
     break;
-  case (INT_CONST):
-    cerr << " = " << cool_yylval.symbol;
+  case TOKVAL_INT:
+    out << " = " << cool_yylval.symbol;
 #ifdef CHECK_TABLES
     inttable.lookup_string(cool_yylval.symbol->get_string());
 #endif
     break;
-  case (BOOL_CONST):
-    cerr << (cool_yylval.boolean ? " = true" : " = false");
+  case TOKVAL_BOOL:
+    out << (cool_yylval.boolean ? " = true" : " = false");
     break;
-  case (TYPEID):
-  case (OBJECTID):
-    cerr << " = " << cool_yylval.symbol;
+  case TOKVAL_ID:
+    out << " = " << cool_yylval.symbol;
 #ifdef CHECK_TABLES
     idtable.lookup_string(cool_yylval.symbol->get_string());
 #endif
     break;
-  case (ERROR): 
-    cerr << " = ";
-    print_escaped_string(cerr, cool_yylval.error_msg);
+  case TOKVAL_ERROR:
+    out << " = ";
+    print_escaped_string(out, cool_yylval.error_msg);
+    break;
+  case TOKVAL_NONE:
     break;
   }
 }
 
+void print_cool_token(int tok)
+{
+  print_cool_token(cerr, tok);
+}
+
 // dump the token in format readable by the sceond phase token lexer
 void dump_cool_token(ostream& out, int lineno, int token, YYSTYPE yylval) {
     out << "#" << lineno << " " << cool_token_to_string(token);
 
-    switch (token) {
-    case (STR_CONST):
+    switch (token_value(token)) {
+    case TOKVAL_STR:
 	out << " \"";
 	print_escaped_string(out, cool_yylval.symbol->get_string());
 	out << "\"";
@@ -173,23 +223,22 @@ void dump_cool_token(ostream& out, int lineno, int token, YYSTYPE yylval) {
 	stringtable.lookup_string(cool_yylval.symbol->get_string());
 #endif
 	break;
-    case (INT_CONST):
+    case TOKVAL_INT:
 	out << " " << cool_yylval.symbol;
 #ifdef CHECK_TABLES
 	inttable.lookup_string(cool_yylval.symbol->get_string());
 #endif
 	break;
-    case (BOOL_CONST):
+    case TOKVAL_BOOL:
 	out << (cool_yylval.boolean ? " true" : " false");
 	break;
-    case (TYPEID):
-    case (OBJECTID):
+    case TOKVAL_ID:
 	out << " " << cool_yylval.symbol;
 #ifdef CHECK_TABLES
 	idtable.lookup_string(cool_yylval.symbol->get_string());
 #endif
 	break;
-    case (ERROR): 
+    case TOKVAL_ERROR:
         // sm: I've changed assignment 2 so students are supposed to
         // *not* coalesce error characters into one string; therefore,
         // if we see an "empty" string here, we can safely assume the
@@ -204,8 +253,10 @@ void dump_cool_token(ostream& out, int lineno, int token, YYSTYPE yylval) {
           out << "\"";
           break;
         }
+    case TOKVAL_NONE:
+	break;
     }
-    out << endl;
+    out << '\n';
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -215,8 +266,88 @@ void dump_cool_token(ostream& out, int lineno, int token, YYSTYPE yylval) {
 // function to add pad
 //
 ///////////////////////////////////////////////////////////////////////////
-const char *pad(int n) {
-    if (n > 80) return padding;
-    if (n <= 0)  return "";
-    return padding+(80-n);
+pad::pad(int n) {
+    this->n = (n < 0 || compact_dump) ? 0 : n;
+}
+
+ostream& operator<<(ostream& stream, const pad& p) {
+    int n = p.n;
+    for (; n > 80; n -= 80)
+	stream.write(padding, 80);
+    return stream.write(padding, n);
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+// buffer_cout
+//
+// cool_outbuf collects output in a 64K buffer and hands it to stdio with
+// one fwrite when the buffer fills or the stream is flushed.  stdout is
+// given a buffer of the same size, so a full cool_outbuf goes straight
+// to write(2), while flushing a partial one only copies it into stdio,
+// behind anything else written to stdout (e.g. by a lexer's actions).
+// stdio itself is flushed at exit.
+//
+// A terminal keeps the usual line-at-a-time output.
+//
+///////////////////////////////////////////////////////////////////////////
+class cool_outbuf : public std::streambuf {
+private:
+    FILE *file;
+    char buf[1 << 16];
+    int drain();
+protected:
+    int_type overflow(int_type c);
+    std::streamsize xsputn(const char *s, std::streamsize n);
+    int sync();
+public:
+    cool_outbuf(FILE *f) : file(f) { setp(buf, buf + sizeof(buf)); }
+};
+
+int cool_outbuf::drain() {
+    size_t n = pptr() - pbase();
+    setp(buf, buf + sizeof(buf));
+    return (n == 0 || fwrite(buf, 1, n, file) == n) ? 0 : -1;
+}
+
+cool_outbuf::int_type cool_outbuf::overflow(int_type c) {
+    if (drain() < 0)
+	return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+// spans too big to be worth copying go straight out behind the buffer
+std::streamsize cool_outbuf::xsputn(const char *s, std::streamsize n) {
+    if (n > epptr() - pptr()) {
+	if (drain() < 0)
+	    return 0;
+	if (n >= (std::streamsize) sizeof(buf))
+	    return fwrite(s, 1, n, file);
+    }
+    memcpy(pptr(), s, n);
+    pbump(n);
+    return n;
+}
+
+int cool_outbuf::sync() {
+    return drain();
+}
+
+static void flush_cout() {
+    cout.flush();
+}
+
+void buffer_cout() {
+    static char stdout_buf[1 << 16];
+    static cool_outbuf out(stdout);
+
+    if (isatty(fileno(stdout)))
+	return;
+    setvbuf(stdout, stdout_buf, _IOFBF, sizeof(stdout_buf));
+    cout.rdbuf(&out);
+    atexit(flush_cout);
 }
@@ -0,0 +1,74 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////
+//
+//  work-pool.cc
+//
+//  The work-stealing pool of work-pool.h.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include "work-pool.h"
+
+work_pool::work_pool(int threads)
+  : nthreads(threads < 1 ? 1 : threads), queues(nthreads)
+{
+}
+
+//
+// The next job for thread "self": its own newest, or else the oldest
+// of the first other thread that has one.
+//
+bool work_pool::take(int self, int& job)
+{
+  {
+    std::lock_guard<std::mutex> hold(queues[self].lock);
+    if (!queues[self].jobs.empty()) {
+      job = queues[self].jobs.back();
+      queues[self].jobs.pop_back();
+      return true;
+    }
+  }
+  for (int i = 1; i < nthreads; i++) {
+    queue& victim = queues[(self + i) % nthreads];
+    std::lock_guard<std::mutex> hold(victim.lock);
+    if (!victim.jobs.empty()) {
+      job = victim.jobs.front();
+      victim.jobs.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void work_pool::work(int self, const std::function<void(int)>& run)
+{
+  int job;
+  while (take(self, job))
+    run(job);
+}
+
+void work_pool::run(const std::vector<int>& jobs,
+		    const std::function<void(int)>& run)
+{
+  int nworkers = nthreads < (int) jobs.size() ? nthreads : jobs.size();
+
+  //
+  // Dealt so that each queue's back, where its owner starts, holds the
+  // biggest of the jobs it was given.
+  //
+  for (int i = jobs.size() - 1; i >= 0; i--)
+    queues[i % (nworkers ? nworkers : 1)].jobs.push_back(jobs[i]);
+
+  std::vector<std::thread> workers;
+  for (int w = 1; w < nworkers; w++)
+    workers.push_back(std::thread(&work_pool::work, this, w, std::cref(run)));
+  work(0, run);
+  for (size_t w = 0; w < workers.size(); w++)
+    workers[w].join();
+}
@@ -0,0 +1 @@
+../cool-support/src/ast-binary.cc
\ No newline at end of file
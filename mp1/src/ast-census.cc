@@ -0,0 +1 @@
+../cool-support/src/ast-census.cc
\ No newline at end of file
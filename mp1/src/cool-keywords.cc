@@ -0,0 +1 @@
+../cool-support/src/cool-keywords.cc
\ No newline at end of file
@@ -55,7 +55,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 1
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -70,8 +70,6 @@
 #define yyerror         cool_yyerror
 #define yydebug         cool_yydebug
 #define yynerrs         cool_yynerrs
-#define yylval          cool_yylval
-#define yychar          cool_yychar
 
 /* First part of user prologue.  */
 #line 6 "cool.y"
@@ -83,16 +81,25 @@
 
 /* Add your own C declarations here */
 
+/* Tokens come from next_cool_token (token-stream.cc), which reads the
+   binary token stream itself and passes text streams to cool_yylex.
+   The parser is pure, so that several files can be parsed at once (see
+   parallel-parse.cc); its yylex, defined below, hands it the value that
+   next_cool_token left in cool_yylval. */
+#include <sstream>
+#undef yylex
+
 
 /************************************************************************/
 /*                DONT CHANGE ANYTHING IN THIS SECTION                  */
 
-extern int yylex();           /* the entry point to the lexer  */
-extern int curr_lineno;
-extern char *curr_filename;
-Program ast_root;            /* the result of the parse  */
-Classes parse_results;       /* for use in semantic analysis */
-int omerrs = 0;              /* number of errors in lexing and parsing */
+extern int next_cool_token(); /* the entry point to the lexer  */
+extern parser_local int curr_lineno;
+extern parser_local char *curr_filename;
+parser_local Program ast_root;       /* the result of the parse  */
+parser_local Classes parse_results;  /* for use in semantic analysis */
+parser_local int omerrs = 0;         /* number of errors in lexing and parsing */
+parser_local std::ostringstream *parse_errors; /* if set, errors go here */
 
 /*
    The parser will always call the yyerror function when it encounters a parse
@@ -118,7 +125,7 @@ void yyerror(const char *s);
 extern int VERBOSE_ERRORS;
 
 
-#line 122 "cool.tab.c"
+#line 129 "cool.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -188,6 +195,28 @@ typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
 
+/* Unqualified %code blocks.  */
+#line 103 "cool.y"
+
+parser_local YYSTYPE cool_yylval;    /* the value of the last token read */
+static parser_local int last_token;  /* for yyerror */
+
+/* Set by yyerror after more than 20 errors in a file whose errors are
+   buffered (frontend -j): a worker thread may not exit, so the parse
+   is ended instead, and the thread that started it exits once every
+   file's errors are out. */
+parser_local bool parse_halted;
+
+static int yylex(YYSTYPE *lvalp)
+{
+  if (parse_halted)
+    return last_token = 0;
+  last_token = next_cool_token();
+  *lvalp = cool_yylval;
+  return last_token;
+}
+
+#line 220 "cool.tab.c"
 
 #ifdef short
 # undef short
@@ -571,7 +600,7 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,   109,   109,   113,   115,   120,   123,   129
+       0,   142,   142,   146,   148,   153,   156,   162
 };
 #endif
 
@@ -881,13 +910,6 @@ yydestruct (const char *yymsg,
 }
 
 
-/* Lookahead token kind.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 
@@ -899,6 +921,19 @@ int yynerrs;
 int
 yyparse (void)
 {
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
     yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus = 0;
@@ -1051,7 +1086,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex ();
+      yychar = yylex (&yylval);
     }
 
   if (yychar <= YYEOF)
@@ -1139,44 +1174,44 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* program: class_list  */
-#line 109 "cool.y"
+#line 142 "cool.y"
                      { ast_root = program((yyvsp[0].classes)); }
-#line 1145 "cool.tab.c"
+#line 1180 "cool.tab.c"
     break;
 
   case 3: /* class_list: class  */
-#line 114 "cool.y"
+#line 147 "cool.y"
                 { (yyval.classes) = single_Classes((yyvsp[0].class_)); }
-#line 1151 "cool.tab.c"
+#line 1186 "cool.tab.c"
     break;
 
   case 4: /* class_list: class_list class  */
-#line 116 "cool.y"
+#line 149 "cool.y"
                 { (yyval.classes) = append_Classes((yyvsp[-1].classes),single_Classes((yyvsp[0].class_))); }
-#line 1157 "cool.tab.c"
+#line 1192 "cool.tab.c"
     break;
 
   case 5: /* class: CLASS TYPEID '{' dummy_feature_list '}' ';'  */
-#line 121 "cool.y"
+#line 154 "cool.y"
                 { (yyval.class_) = class_((yyvsp[-4].symbol),idtable.add_string("Object"),(yyvsp[-2].features),
                               stringtable.add_string(curr_filename)); }
-#line 1164 "cool.tab.c"
+#line 1199 "cool.tab.c"
     break;
 
   case 6: /* class: CLASS TYPEID INHERITS TYPEID '{' dummy_feature_list '}' ';'  */
-#line 124 "cool.y"
+#line 157 "cool.y"
                 { (yyval.class_) = class_((yyvsp[-6].symbol),(yyvsp[-4].symbol),(yyvsp[-2].features),stringtable.add_string(curr_filename)); }
-#line 1170 "cool.tab.c"
+#line 1205 "cool.tab.c"
     break;
 
   case 7: /* dummy_feature_list: %empty  */
-#line 129 "cool.y"
+#line 162 "cool.y"
                 {  (yyval.features) = nil_Features(); }
-#line 1176 "cool.tab.c"
+#line 1211 "cool.tab.c"
     break;
 
 
-#line 1180 "cool.tab.c"
+#line 1215 "cool.tab.c"
 
       default: break;
     }
@@ -1369,22 +1404,28 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 133 "cool.y"
+#line 166 "cool.y"
 
 
 /* This function is called automatically when Bison detects a parse error. */
 void yyerror(const char *s)
 {
-  cerr << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
+  if (parse_halted)
+    return;
+  ostream& err = parse_errors ? *parse_errors : cerr;
+  err << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
     << s << " at or near ";
-  print_cool_token(yychar);
-  cerr << endl;
+  print_cool_token(err, last_token);
+  err << endl;
   omerrs++;
 
   if(omerrs>20) {
       if (VERBOSE_ERRORS)
-         fprintf(stderr, "More than 20 errors\n");
-      exit(1);
+         err << "More than 20 errors\n";
+      if (parse_errors)
+         parse_halted = true;
+      else
+         exit(1);
   }
 }
 
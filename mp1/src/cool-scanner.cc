@@ -0,0 +1 @@
+../cool-support/src/cool-scanner.cc
\ No newline at end of file
@@ -83,43 +83,12 @@ extern int cool_yydebug;
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Token kinds.  */
-#define YYEMPTY -2
-#define YYEOF 0
-#define YYerror 256
-#define YYUNDEF 284
-#define CLASS 258
-#define ELSE 259
-#define FI 260
-#define IF 261
-#define IN 262
-#define INHERITS 263
-#define LET 264
-#define LOOP 265
-#define POOL 266
-#define THEN 267
-#define WHILE 268
-#define CASE 269
-#define ESAC 270
-#define OF 271
-#define DARROW 272
-#define NEW 273
-#define ISVOID 274
-#define STR_CONST 275
-#define INT_CONST 276
-#define BOOL_CONST 277
-#define TYPEID 278
-#define OBJECTID 279
-#define ASSIGN 280
-#define NOT 281
-#define LE 282
-#define ERROR 283
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 51 "cool.y"
+#line 60 "cool.y"
 
   Boolean boolean;
   Symbol symbol;
@@ -136,7 +105,7 @@ union YYSTYPE
   Expressions expressions;
   char *error_msg;
 
-#line 140 "cool.tab.h"
+#line 109 "cool.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -145,7 +114,6 @@ typedef union YYSTYPE YYSTYPE;
 #endif
 
 
-extern YYSTYPE cool_yylval;
 
 
 int cool_yyparse (void);
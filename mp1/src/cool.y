@@ -11,16 +11,25 @@
 
 /* Add your own C declarations here */
 
+/* Tokens come from next_cool_token (token-stream.cc), which reads the
+   binary token stream itself and passes text streams to cool_yylex.
+   The parser is pure, so that several files can be parsed at once (see
+   parallel-parse.cc); its yylex, defined below, hands it the value that
+   next_cool_token left in cool_yylval. */
+#include <sstream>
+#undef yylex
+
 
 /************************************************************************/
 /*                DONT CHANGE ANYTHING IN THIS SECTION                  */
 
-extern int yylex();           /* the entry point to the lexer  */
-extern int curr_lineno;
-extern char *curr_filename;
-Program ast_root;            /* the result of the parse  */
-Classes parse_results;       /* for use in semantic analysis */
-int omerrs = 0;              /* number of errors in lexing and parsing */
+extern int next_cool_token(); /* the entry point to the lexer  */
+extern parser_local int curr_lineno;
+extern parser_local char *curr_filename;
+parser_local Program ast_root;       /* the result of the parse  */
+parser_local Classes parse_results;  /* for use in semantic analysis */
+parser_local int omerrs = 0;         /* number of errors in lexing and parsing */
+parser_local std::ostringstream *parse_errors; /* if set, errors go here */
 
 /*
    The parser will always call the yyerror function when it encounters a parse
@@ -86,6 +95,30 @@ extern int VERBOSE_ERRORS;
 
 /*  DON'T CHANGE ANYTHING ABOVE THIS LINE, OR YOUR PARSER WONT WORK       */
 /**************************************************************************/
+
+/* A pure parser keeps its state in yyparse's frame, so that each thread
+   parsing a file has its own (see parallel-parse.cc). */
+%define api.pure
+
+%code {
+parser_local YYSTYPE cool_yylval;    /* the value of the last token read */
+static parser_local int last_token;  /* for yyerror */
+
+/* Set by yyerror after more than 20 errors in a file whose errors are
+   buffered (frontend -j): a worker thread may not exit, so the parse
+   is ended instead, and the thread that started it exits once every
+   file's errors are out. */
+parser_local bool parse_halted;
+
+static int yylex(YYSTYPE *lvalp)
+{
+  if (parse_halted)
+    return last_token = 0;
+  last_token = next_cool_token();
+  *lvalp = cool_yylval;
+  return last_token;
+}
+}
  
    /* Complete the nonterminal list below, giving a type for the semantic
       value of each non terminal. (See section 3.6 in the bison 
@@ -135,16 +168,22 @@ dummy_feature_list:        /* empty */
 /* This function is called automatically when Bison detects a parse error. */
 void yyerror(const char *s)
 {
-  cerr << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
+  if (parse_halted)
+    return;
+  ostream& err = parse_errors ? *parse_errors : cerr;
+  err << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
     << s << " at or near ";
-  print_cool_token(yychar);
-  cerr << endl;
+  print_cool_token(err, last_token);
+  err << endl;
   omerrs++;
 
   if(omerrs>20) {
       if (VERBOSE_ERRORS)
-         fprintf(stderr, "More than 20 errors\n");
-      exit(1);
+         err << "More than 20 errors\n";
+      if (parse_errors)
+         parse_halted = true;
+      else
+         exit(1);
   }
 }
 
@@ -0,0 +1 @@
+../cool-support/src/coolc.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/escape-check.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/frontend-phase.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/hand-lex.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/incremental-check.cc
\ No newline at end of file
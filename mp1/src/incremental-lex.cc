@@ -0,0 +1 @@
+../cool-support/src/incremental-lex.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/lexbench.cc
\ No newline at end of file
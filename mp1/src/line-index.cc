@@ -0,0 +1 @@
+../cool-support/src/line-index.cc
\ No newline at end of file
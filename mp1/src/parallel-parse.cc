@@ -0,0 +1 @@
+../cool-support/src/parallel-parse.cc
\ No newline at end of file
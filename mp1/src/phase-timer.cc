@@ -0,0 +1 @@
+../cool-support/src/phase-timer.cc
\ No newline at end of file
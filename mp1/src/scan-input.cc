@@ -0,0 +1 @@
+../cool-support/src/scan-input.cc
\ No newline at end of file
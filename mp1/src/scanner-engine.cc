@@ -0,0 +1 @@
+../cool-support/src/scanner-engine.cc
\ No newline at end of file
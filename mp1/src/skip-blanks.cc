@@ -0,0 +1 @@
+../cool-support/src/skip-blanks.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/source-scan.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/string-const.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../cool-support/src/token-stream.cc
\ No newline at end of file
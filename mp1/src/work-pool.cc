@@ -0,0 +1 @@
+../cool-support/src/work-pool.cc
\ No newline at end of file